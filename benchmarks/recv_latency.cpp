@@ -0,0 +1,179 @@
+// Benchmark: packet-to-callback latency of the receive backends.
+//
+// Sends paced beat packets to 127.0.0.1:50001 and measures the time from
+// just before sendto() to the start of the beat callback. Each packet carries
+// its sequence number in the next-beat field so the callback can find the
+// matching send time.
+//
+// Usage: prolink_bench_recv_latency [packets] [interval_us]
+#include "prolink/prolink.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr uint8_t kHeader[10] = {0x51, 0x73, 0x70, 0x74, 0x31, 0x57, 0x6d, 0x4a, 0x4f, 0x4c};
+
+// Minimal 0x60-byte beat packet with the sequence number as next_beat_ms.
+std::vector<uint8_t> BeatPacket(uint32_t sequence) {
+  std::vector<uint8_t> packet(0x60, 0);
+  std::memcpy(packet.data(), kHeader, sizeof(kHeader));
+  packet[0x0a] = 0x28;
+  std::memcpy(packet.data() + 0x0b, "bench", 5);
+  packet[0x1f] = 0x01;
+  packet[0x21] = 0x02;
+  packet[0x23] = 0x3c;
+  packet[0x24] = static_cast<uint8_t>(sequence >> 24);
+  packet[0x25] = static_cast<uint8_t>(sequence >> 16);
+  packet[0x26] = static_cast<uint8_t>(sequence >> 8);
+  packet[0x27] = static_cast<uint8_t>(sequence);
+  packet[0x55] = 0x10;
+  packet[0x5a] = 0x32;
+  packet[0x5c] = 0x01;
+  packet[0x5f] = 0x02;
+  return packet;
+}
+
+struct Mode {
+  const char* name;
+  prolink::RecvBackend backend;
+  prolink::BusyPollBackoff backoff;
+};
+
+struct Result {
+  size_t received = 0;
+  std::vector<double> latencies_us;
+};
+
+Result Run(const Mode& mode, uint32_t packets, std::chrono::microseconds interval) {
+  prolink::Config config;
+  config.bind_address = "127.0.0.1";
+  config.send_beats = false;
+  config.send_status = false;
+  config.send_announces = false;
+  config.recv_backend = mode.backend;
+  config.busy_poll_backoff = mode.backoff;
+
+  // Send times in steady-clock nanoseconds, published before each sendto().
+  std::vector<std::atomic<int64_t>> sent_ns(packets);
+  std::vector<int64_t> latency_ns(packets, -1);
+  std::atomic<size_t> received{0};
+
+  prolink::Session session(config);
+  session.SetBeatCallback([&](const prolink::BeatInfo& beat) {
+    const auto now = Clock::now();
+    const uint32_t sequence = beat.next_beat_ms;
+    if (sequence < packets) {
+      latency_ns[sequence] = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                 now.time_since_epoch()).count() -
+                             sent_ns[sequence].load(std::memory_order_acquire);
+    }
+    received.fetch_add(1, std::memory_order_release);
+  });
+  if (!session.Start()) {
+    std::cerr << mode.name << ": failed to start: " << session.GetLastError() << std::endl;
+    return {};
+  }
+
+  const int fd = ::socket(AF_INET, SOCK_DGRAM, 0);
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(prolink::kBeatPort);
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+  // Warm up the receive path before measuring.
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  auto next = Clock::now();
+  for (uint32_t i = 0; i < packets; ++i) {
+    const auto packet = BeatPacket(i);
+    while (Clock::now() < next) {
+    }
+    sent_ns[i].store(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                         Clock::now().time_since_epoch())
+                         .count(),
+                     std::memory_order_release);
+    ::sendto(fd, packet.data(), packet.size(), 0, reinterpret_cast<const sockaddr*>(&addr),
+             sizeof(addr));
+    next += interval;
+  }
+  const auto deadline = Clock::now() + std::chrono::seconds(1);
+  while (received.load(std::memory_order_acquire) < packets && Clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  session.Stop();
+  ::close(fd);
+
+  Result result;
+  result.received = received.load();
+  for (const int64_t ns : latency_ns) {
+    if (ns >= 0) {
+      result.latencies_us.push_back(static_cast<double>(ns) / 1000.0);
+    }
+  }
+  std::sort(result.latencies_us.begin(), result.latencies_us.end());
+  return result;
+}
+
+double Percentile(const std::vector<double>& sorted, double p) {
+  if (sorted.empty()) {
+    return 0.0;
+  }
+  const size_t index = std::min(
+      sorted.size() - 1, static_cast<size_t>(p / 100.0 * static_cast<double>(sorted.size())));
+  return sorted[index];
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const uint32_t packets =
+      argc > 1 ? static_cast<uint32_t>(std::strtoul(argv[1], nullptr, 10)) : 5000;
+  const auto interval = std::chrono::microseconds(argc > 2 ? std::atoi(argv[2]) : 500);
+
+  const Mode modes[] = {
+      {"select", prolink::RecvBackend::kSelect, prolink::BusyPollBackoff::kPause},
+#ifdef __linux__
+      {"epoll", prolink::RecvBackend::kEpoll, prolink::BusyPollBackoff::kPause},
+#endif
+      {"busy-poll/spin", prolink::RecvBackend::kBusyPoll, prolink::BusyPollBackoff::kSpin},
+      {"busy-poll/pause", prolink::RecvBackend::kBusyPoll, prolink::BusyPollBackoff::kPause},
+      {"busy-poll/yield", prolink::RecvBackend::kBusyPoll, prolink::BusyPollBackoff::kYield},
+  };
+
+  if (std::thread::hardware_concurrency() < 2) {
+    std::cout << "warning: fewer than 2 CPUs; busy-poll modes compete with the sender "
+                 "for the only core and will look worse than the blocking backends\n";
+  }
+  std::cout << packets << " beats every " << interval.count() << " us over loopback\n"
+            << "latency in microseconds (sendto -> beat callback)\n\n";
+  std::cout << std::left << std::setw(18) << "backend" << std::right << std::setw(10) << "recv"
+            << std::setw(10) << "p50" << std::setw(10) << "p90" << std::setw(10) << "p99"
+            << std::setw(10) << "p99.9" << std::setw(10) << "max" << "\n";
+  std::cout << std::fixed << std::setprecision(1);
+  for (const Mode& mode : modes) {
+    const Result result = Run(mode, packets, interval);
+    const auto& l = result.latencies_us;
+    std::cout << std::left << std::setw(18) << mode.name << std::right << std::setw(10)
+              << result.received << std::setw(10) << Percentile(l, 50) << std::setw(10)
+              << Percentile(l, 90) << std::setw(10) << Percentile(l, 99) << std::setw(10)
+              << Percentile(l, 99.9) << std::setw(10) << (l.empty() ? 0.0 : l.back()) << "\n";
+  }
+  return 0;
+}
@@ -34,23 +34,36 @@ bool ParseMac(const std::string& text, std::array<uint8_t, 6>* out) {
 }  // namespace
 
 int main(int argc, char** argv) {
-  if (argc < 4) {
+  const bool auto_network = argc > 1 && std::string(argv[1]).rfind("--auto", 0) == 0;
+  if (argc < 4 && !auto_network) {
     std::cout << "Usage: prolink_virtual_cdj <device_ip> <broadcast_ip> <mac> "
+                 "[device_id] [name] [tempo] [--follow-master]\n"
+                 "       prolink_virtual_cdj --auto[=<interface|subnet>] "
                  "[device_id] [name] [tempo] [--follow-master]\n";
     return 1;
   }
 
   prolink::Config config;
-  config.device_ip = argv[1];
-  config.broadcast_address = argv[2];
-  config.announce_address = argv[2];
+  int first_optional = 4;
+  if (auto_network) {
+    const std::string arg = argv[1];
+    config.auto_network = true;
+    if (arg.size() > 7 && arg[6] == '=') {
+      config.network_interface = arg.substr(7);
+    }
+    first_optional = 2;
+  } else {
+    config.device_ip = argv[1];
+    config.broadcast_address = argv[2];
+    config.announce_address = argv[2];
 
-  if (!ParseMac(argv[3], &config.mac_address)) {
-    std::cerr << "Invalid MAC address format\n";
-    return 1;
+    if (!ParseMac(argv[3], &config.mac_address)) {
+      std::cerr << "Invalid MAC address format\n";
+      return 1;
+    }
   }
 
-  for (int i = 4; i < argc; ++i) {
+  for (int i = first_optional; i < argc; ++i) {
     const std::string arg = argv[i];
     if (arg == "--follow-master") {
       config.follow_master = true;
@@ -77,6 +90,12 @@ int main(int argc, char** argv) {
     std::cerr << "Failed to start session: " << session.GetLastError() << std::endl;
     return 1;
   }
+  if (auto_network) {
+    for (const auto& iface : session.GetInterfaces()) {
+      std::cout << "Using " << iface.name << ": " << iface.device_ip << " -> "
+                << iface.broadcast_address << std::endl;
+    }
+  }
   std::cout << "Virtual CDJ running. Press Enter to stop." << std::endl;
   std::string line;
   std::getline(std::cin, line);
@@ -346,9 +346,12 @@ void ShowDevices(prolink::Session& session) {
 }  // namespace
 
 int main(int argc, char** argv) {
-  if (argc < 4) {
+  const bool auto_network = argc > 1 && std::string(argv[1]).rfind("--auto", 0) == 0;
+  if (argc < 4 && !auto_network) {
     std::cout << "Usage: " << argv[0]
-              << " <device_ip> <broadcast_ip> <mac> [device_id] [name] [tempo]\n\n";
+              << " <device_ip> <broadcast_ip> <mac> [device_id] [name] [tempo]\n";
+    std::cout << "       " << argv[0]
+              << " --auto[=<interface|subnet>] [device_id] [name] [tempo]\n\n";
     std::cout << "Example:\n";
     std::cout << "  " << argv[0]
               << " 192.168.1.100 192.168.1.255 aa:bb:cc:dd:ee:ff 7 MyVirtualCDJ 128\n\n";
@@ -356,6 +359,7 @@ int main(int argc, char** argv) {
     std::cout << "  device_ip     - Your computer's IP address on the DJ network\n";
     std::cout << "  broadcast_ip  - Subnet broadcast address (e.g., 192.168.1.255)\n";
     std::cout << "  mac           - MAC address in format aa:bb:cc:dd:ee:ff\n";
+    std::cout << "  --auto        - Detect IP, broadcast and MAC from an interface\n";
     std::cout << "  device_id     - Optional device number (1-4 for players, 5+ for virtual)\n";
     std::cout << "  name          - Optional device name (default: VirtualCDJ)\n";
     std::cout << "  tempo         - Optional initial BPM (default: 128.0)\n";
@@ -363,26 +367,36 @@ int main(int argc, char** argv) {
   }
 
   prolink::Config config;
-  config.device_ip = argv[1];
-  config.broadcast_address = argv[2];
-  config.announce_address = argv[2];
+  int first_optional = 4;
+  if (auto_network) {
+    const std::string arg = argv[1];
+    config.auto_network = true;
+    if (arg.size() > 7 && arg[6] == '=') {
+      config.network_interface = arg.substr(7);
+    }
+    first_optional = 2;
+  } else {
+    config.device_ip = argv[1];
+    config.broadcast_address = argv[2];
+    config.announce_address = argv[2];
 
-  if (!ParseMac(argv[3], &config.mac_address)) {
-    std::cerr << "Error: Invalid MAC address format\n";
-    return 1;
+    if (!ParseMac(argv[3], &config.mac_address)) {
+      std::cerr << "Error: Invalid MAC address format\n";
+      return 1;
+    }
   }
 
   // Optional parameters
-  if (argc > 4) {
-    config.device_number = static_cast<uint8_t>(std::atoi(argv[4]));
+  if (argc > first_optional) {
+    config.device_number = static_cast<uint8_t>(std::atoi(argv[first_optional]));
   }
-  if (argc > 5) {
-    config.device_name = argv[5];
+  if (argc > first_optional + 1) {
+    config.device_name = argv[first_optional + 1];
   } else {
     config.device_name = "VirtualCDJ";
   }
-  if (argc > 6) {
-    config.tempo_bpm = std::atof(argv[6]);
+  if (argc > first_optional + 2) {
+    config.tempo_bpm = std::atof(argv[first_optional + 2]);
   }
 
   // Enable all features
@@ -437,8 +451,11 @@ int main(int argc, char** argv) {
   std::cout << kColorGreen << "✓ Virtual CDJ started successfully!\n" << kColorReset;
   std::cout << "  Device: " << config.device_name << " (ID: "
             << +config.device_number << ")\n";
-  std::cout << "  Network: " << config.device_ip << " -> "
-            << config.broadcast_address << "\n\n";
+  for (const auto& iface : session.GetInterfaces()) {
+    std::cout << "  Network: " << iface.device_ip << " -> " << iface.broadcast_address
+              << "\n";
+  }
+  std::cout << "\n";
 
   std::cout << "Waiting for device discovery...\n";
   std::this_thread::sleep_for(std::chrono::seconds(3));
@@ -0,0 +1,489 @@
+#pragma once
+
+// Pro DJ Link packet codec: decoding and encoding over caller-owned buffers.
+// Everything declared here is built into the prolink_codec library, which
+// has no threads, no sockets, no heap allocation and is compiled without
+// exceptions, so it can run on real-time threads. prolink.h adds the
+// Session on top of it.
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+namespace prolink {
+
+/**
+ * Well-known Pro DJ Link UDP ports.
+ */
+constexpr uint16_t kAnnouncePort = 50000;
+constexpr uint16_t kBeatPort = 50001;
+constexpr uint16_t kStatusPort = 50002;
+/// Port argument for datagrams whose receive port is unknown; they are
+/// classified by packet type alone.
+constexpr uint16_t kAnyPort = 0;
+
+/**
+ * Protocol constants used by beat/status parsing.
+ */
+constexpr uint8_t kDeviceNameLength = 20;
+constexpr uint32_t kNeutralPitch = 0x100000;
+
+/**
+ * Packet type identifiers used in the first byte after the magic header.
+ */
+enum class PacketType : uint8_t {
+  kFaderStart = 0x02,
+  kChannelsOnAir = 0x03,
+  kDeviceKeepAlive = 0x06,
+  kCdjStatus = 0x0a,
+  kPrecisePosition = 0x0b,
+  kMasterHandoffRequest = 0x26,
+  kMasterHandoffResponse = 0x27,
+  kBeat = 0x28,
+  kMixerStatus = 0x29,
+  kSyncControl = 0x2a,
+};
+
+/**
+ * Sync control commands (packet type 0x2a).
+ */
+enum class SyncCommand : uint8_t {
+  kEnableSync = 0x10,
+  kDisableSync = 0x20,
+  kBecomeMaster = 0x01,
+};
+
+/**
+ * Per-channel command in a mixer fader start packet (type 0x02).
+ */
+enum class FaderStartCommand : uint8_t {
+  kStart = 0x00,
+  kStop = 0x01,
+  kNoChange = 0x02,
+};
+
+/// Mixer channels reported in on-air and fader start packets.
+constexpr uint8_t kMixerChannelCount = 4;
+
+/**
+ * Media slot a player loaded its track from (status packet 0x29).
+ */
+enum class TrackSourceSlot : uint8_t {
+  kNoTrack = 0x00,
+  kCd = 0x01,
+  kSd = 0x02,
+  kUsb = 0x03,
+  kCollection = 0x04,
+  kUsb2 = 0x07,
+};
+
+/**
+ * Kind of track loaded in a player (status packet 0x2a).
+ */
+enum class TrackType : uint8_t {
+  kNoTrack = 0x00,
+  kRekordbox = 0x01,
+  kUnanalyzed = 0x02,
+  kCdDigitalAudio = 0x05,
+};
+
+/**
+ * Player transport state (status packet 0x7b). Unlisted values are passed
+ * through unchanged.
+ */
+enum class PlayState : uint8_t {
+  kNoTrack = 0x00,
+  kLoading = 0x02,
+  kPlaying = 0x03,
+  kLooping = 0x04,
+  kPaused = 0x05,
+  kCued = 0x06,
+  kCuePlaying = 0x07,
+  kCueScratching = 0x08,
+  kSearching = 0x09,
+  kSpunDown = 0x0e,
+  kEnded = 0x11,
+};
+
+/**
+ * Optional StatusInfo field groups. Session::SetStatusCallback() and
+ * Materialize(const StatusView&) only decode the groups in their mask; tempo,
+ * beat and the master/sync/playing flags are always filled in.
+ *
+ * - kStatusFieldTrack: source player, slot, type, rekordbox id, track number.
+ * - kStatusFieldPlayState: play state bytes plus the on-air and BPM-sync flags.
+ * - kStatusFieldCounters: firmware version, sync counter, beats to cue and
+ *   packet counter.
+ */
+constexpr uint32_t kStatusFieldTrack = 1u << 0;
+constexpr uint32_t kStatusFieldPlayState = 1u << 1;
+constexpr uint32_t kStatusFieldCounters = 1u << 2;
+constexpr uint32_t kStatusFieldsCore = 0;
+constexpr uint32_t kStatusFieldsAll =
+    kStatusFieldTrack | kStatusFieldPlayState | kStatusFieldCounters;
+
+/// StatusInfo::beats_until_cue when no cue point is ahead.
+constexpr uint16_t kNoUpcomingCue = 0x01ff;
+
+/**
+ * Absolute playhead position broadcast by CDJ-3000 class players on port
+ * 50001 about every 30 ms while a track is loaded.
+ */
+struct PositionInfo {
+  /// Player/device number reported by the device.
+  uint8_t device_number = 0;
+  /// Length of the loaded track in seconds.
+  uint32_t track_length_s = 0;
+  /// Playhead position in milliseconds from the start of the track.
+  uint32_t playhead_ms = 0;
+  /// Pitch adjustment in hundredths of a percent (+325 = +3.25%).
+  int32_t pitch = 0;
+  /// Pitch-adjusted tempo, BPM * 100 (sent with 0.1 BPM resolution).
+  uint32_t bpm = 0;
+  /// Kernel receive timestamp mapped to the steady clock.
+  std::chrono::steady_clock::time_point receive_time;
+  /// Index into Config::interfaces of the ingress interface.
+  uint8_t interface_index = 0;
+
+  /// Pitch adjustment as a percentage.
+  double pitch_percent() const;
+  /// Pitch-adjusted tempo in BPM.
+  double effective_bpm() const;
+};
+
+/**
+ * Channels-on-air packet from a mixer (type 0x03 on port 50001).
+ */
+struct OnAirInfo {
+  /// Device number of the mixer that sent the packet.
+  uint8_t device_number = 0;
+  /// Whether each channel (player 1-4 at index 0-3) is on air.
+  std::array<bool, kMixerChannelCount> on_air = {false, false, false, false};
+  /// Kernel receive timestamp mapped to the steady clock.
+  std::chrono::steady_clock::time_point receive_time;
+};
+
+/**
+ * Fader start packet from a mixer (type 0x02 on port 50001).
+ */
+struct FaderStartInfo {
+  /// Device number of the mixer that sent the packet.
+  uint8_t device_number = 0;
+  /// Command for each channel (player 1-4 at index 0-3).
+  std::array<FaderStartCommand, kMixerChannelCount> commands = {
+      FaderStartCommand::kNoChange, FaderStartCommand::kNoChange,
+      FaderStartCommand::kNoChange, FaderStartCommand::kNoChange};
+  /// Kernel receive timestamp mapped to the steady clock.
+  std::chrono::steady_clock::time_point receive_time;
+};
+
+/**
+ * Non-owning view of a received datagram. Views handed to callbacks point
+ * into the receive buffer and are only valid until the callback returns;
+ * pass a typed view to Materialize() (prolink.h, part of prolink_cpp) to
+ * keep the data.
+ */
+class PacketView {
+ public:
+  PacketView() = default;
+  PacketView(const uint8_t* data, size_t length,
+             std::chrono::steady_clock::time_point receive_time = {},
+             uint8_t interface_index = 0)
+      : data_(data), length_(length), receive_time_(receive_time),
+        interface_index_(interface_index) {}
+
+  const uint8_t* data() const { return data_; }
+  size_t size() const { return length_; }
+  /// Kernel receive timestamp mapped to the steady clock.
+  std::chrono::steady_clock::time_point receive_time() const { return receive_time_; }
+  /// Index into Config::interfaces of the ingress interface.
+  uint8_t interface_index() const { return interface_index_; }
+  /// Player/device number field (0x21).
+  uint8_t device_number() const;
+  /// Device name field with padding trimmed (points into the packet).
+  std::string_view device_name() const;
+
+ protected:
+  const uint8_t* data_ = nullptr;
+  size_t length_ = 0;
+  std::chrono::steady_clock::time_point receive_time_{};
+  uint8_t interface_index_ = 0;
+};
+
+/**
+ * Beat packet (port 50001) decoded on access. Check valid() before reading
+ * fields.
+ */
+class BeatView : public PacketView {
+ public:
+  using PacketView::PacketView;
+
+  /// True if the datagram is a complete beat packet.
+  bool valid() const;
+  uint32_t bpm() const;
+  uint32_t pitch() const;
+  /// Beat within the bar, sanitized to 1 when out of range (as in BeatInfo).
+  uint8_t beat_within_bar() const;
+  uint32_t next_beat_ms() const;
+  uint32_t next_bar_ms() const;
+  double effective_bpm() const;
+};
+
+/**
+ * CDJ status packet (port 50002) decoded on access. Check valid() before
+ * reading fields.
+ */
+class StatusView : public PacketView {
+ public:
+  using PacketView::PacketView;
+
+  /// True if the datagram is a CDJ status packet of at least the minimum size.
+  bool valid() const;
+  std::optional<uint32_t> bpm() const;
+  uint32_t pitch() const;
+  std::optional<uint32_t> beat() const;
+  uint8_t beat_within_bar() const;
+  uint8_t master_handoff_to() const;
+  bool is_master() const;
+  bool is_synced() const;
+  bool is_playing() const;
+  std::optional<double> effective_bpm() const;
+
+  uint8_t track_source_player() const;
+  TrackSourceSlot track_source_slot() const;
+  TrackType track_type() const;
+  uint32_t rekordbox_id() const;
+  uint16_t track_number() const;
+  PlayState play_state() const;
+  uint8_t play_state2() const;
+  uint8_t play_state3() const;
+  bool is_on_air() const;
+  bool is_bpm_synced() const;
+  /// Firmware version field with padding trimmed (points into the packet).
+  std::string_view firmware_version() const;
+  uint32_t sync_counter() const;
+  uint16_t beats_until_cue() const;
+  /// Packet counter, if the packet is long enough to carry it.
+  std::optional<uint32_t> packet_counter() const;
+};
+
+/**
+ * Device keep-alive packet (port 50000) decoded on access. Check valid()
+ * before reading fields.
+ */
+class KeepAliveView : public PacketView {
+ public:
+  using PacketView::PacketView;
+
+  /// True if the datagram is a complete keep-alive packet.
+  bool valid() const;
+  /// Device number field of the keep-alive (0x24).
+  uint8_t device_number() const;
+  /// Device name, falling back to the alternate name offset some devices use.
+  std::string_view device_name() const;
+  uint8_t device_type() const;
+  std::array<uint8_t, 6> mac_address() const;
+  /// Announced IPv4 address in network byte order.
+  uint32_t ip_address() const;
+};
+
+/**
+ * Mixer status packet (port 50002) decoded on access. Check valid() before
+ * reading fields.
+ */
+class MixerStatusView : public PacketView {
+ public:
+  using PacketView::PacketView;
+
+  /// True if the datagram is a complete mixer status packet.
+  bool valid() const;
+  std::optional<uint32_t> bpm() const;
+  uint32_t pitch() const;
+  uint8_t beat_within_bar() const;
+  uint8_t master_handoff_to() const;
+  bool is_master() const;
+};
+
+/**
+ * Instruction set used by ClassifyDatagrams(), picked once from what the CPU
+ * supports.
+ */
+enum class ClassifierIsa {
+  kScalar,
+  kSse2,
+  kAvx2,
+};
+
+/**
+ * A datagram accepted by ClassifyDatagrams().
+ */
+struct ClassifiedDatagram {
+  /// Position of the datagram in the input batch.
+  uint32_t index = 0;
+  /// Packet type byte; types the library does not decode are passed through.
+  uint8_t type = 0;
+};
+
+/**
+ * Batch pre-pass over received datagrams: checks the Pro DJ Link magic, reads
+ * the type byte and enforces the minimum length of each decoded packet type.
+ * All datagrams were received on `port`; decoded types that are only sent to
+ * other ports are dropped, since claim packets on port 50000 reuse the type
+ * bytes of mixer packets on 50001. Writes one entry per accepted datagram to
+ * `out`, which must have room for `count` entries, in input order and returns
+ * the number written.
+ */
+size_t ClassifyDatagrams(const uint8_t* const* data, const size_t* lengths, size_t count,
+                         ClassifiedDatagram* out, uint16_t port = kAnyPort);
+
+/// Implementation ClassifyDatagrams() runs on this CPU.
+ClassifierIsa ActiveClassifierIsa();
+
+/**
+ * Non-owning view of one captured datagram for ParseTempoBatch().
+ */
+struct PacketSpan {
+  const uint8_t* data = nullptr;
+  size_t size = 0;
+  /// Capture timestamp, copied to TempoColumns::timestamp_us.
+  uint64_t timestamp_us = 0;
+};
+
+/// TempoColumns::beat value for rows without a beat number.
+constexpr uint32_t kNoBeatNumber = 0xffffffff;
+/// TempoColumns::bpm value for status rows with no track loaded.
+constexpr uint16_t kNoBpm = 0xffff;
+
+/**
+ * Caller-owned structure-of-arrays output for ParseTempoBatch(). Each
+ * non-null column needs room for one value per input row; null columns are
+ * skipped. Rows that are not complete beat or status packets read as zero.
+ */
+struct TempoColumns {
+  /// PacketType::kBeat or PacketType::kCdjStatus as a byte.
+  uint8_t* type = nullptr;
+  uint8_t* device_number = nullptr;
+  /// Track BPM x 100, or kNoBpm.
+  uint16_t* bpm = nullptr;
+  /// Raw pitch (kNeutralPitch = 0%).
+  uint32_t* pitch = nullptr;
+  /// Status beat number; kNoBeatNumber for beat packets and empty decks.
+  uint32_t* beat = nullptr;
+  /// Beat within the bar (1-8).
+  uint8_t* beat_within_bar = nullptr;
+  /// Status flag byte (0x40 playing, 0x20 master, 0x10 synced); 0 for beats.
+  uint8_t* flags = nullptr;
+  uint64_t* timestamp_us = nullptr;
+  /// Bitmap with bit i (word i / 64, bit i % 64) set when row i failed to
+  /// parse. Needs (count + 63) / 64 words; every word is overwritten.
+  uint64_t* failures = nullptr;
+};
+
+/**
+ * Decode a batch of beat and status packets into columns without per-row
+ * allocation. Returns the number of rows parsed. Rows are independent, so a
+ * batch can be split across threads: give each thread a multiple of 64 rows
+ * and offset the column and failure pointers to match.
+ */
+size_t ParseTempoBatch(const PacketSpan* packets, size_t count, const TempoColumns& out);
+
+/**
+ * Precise position, channels-on-air and fader start packets decoded into
+ * plain structs. Return false if the datagram is not a complete packet of
+ * that type, or a fader start command is not a FaderStartCommand;
+ * receive_time is left unset.
+ */
+bool DecodePosition(const uint8_t* data, size_t length, PositionInfo* out) noexcept;
+bool DecodeOnAir(const uint8_t* data, size_t length, OnAirInfo* out) noexcept;
+bool DecodeFaderStart(const uint8_t* data, size_t length, FaderStartInfo* out) noexcept;
+
+/// Largest packet written by any Encode* function.
+constexpr size_t kMaxEncodedPacketSize = 0x140;
+
+/**
+ * Beat packet fields for EncodeBeat(). Timings are milliseconds until each
+ * upcoming beat or bar.
+ */
+struct BeatFields {
+  uint8_t device_number = 0;
+  std::string_view device_name;
+  /// Tempo, BPM * 100.
+  uint32_t bpm = 0;
+  uint32_t pitch = kNeutralPitch;
+  uint8_t beat_within_bar = 1;
+  uint32_t next_beat_ms = 0;
+  uint32_t second_beat_ms = 0;
+  uint32_t next_bar_ms = 0;
+  uint32_t fourth_beat_ms = 0;
+  uint32_t second_bar_ms = 0;
+  uint32_t eighth_beat_ms = 0;
+};
+
+/**
+ * CDJ status packet fields for EncodeStatus(). The play state bytes are
+ * derived from is_playing.
+ */
+struct StatusFields {
+  uint8_t device_number = 0;
+  std::string_view device_name;
+  /// Tempo, BPM * 100, or kNoBpm without a loaded track.
+  uint32_t bpm = kNoBpm;
+  uint32_t pitch = kNeutralPitch;
+  uint32_t beat = kNoBeatNumber;
+  uint8_t beat_within_bar = 1;
+  bool is_playing = false;
+  bool is_master = false;
+  bool is_synced = false;
+  uint8_t master_handoff_to = 0xff;
+  uint32_t packet_counter = 0;
+};
+
+/**
+ * Keep-alive packet fields for EncodeKeepAlive().
+ */
+struct KeepAliveFields {
+  uint8_t device_number = 0;
+  uint8_t device_type = 0x01;
+  std::string_view device_name;
+  std::array<uint8_t, 6> mac_address = {0, 0, 0, 0, 0, 0};
+  /// IPv4 address in network byte order.
+  uint32_t ip_address = 0;
+};
+
+/**
+ * Packet encoders. Each writes one complete packet to `out` and returns its
+ * size, or returns 0 and writes nothing if `capacity` is too small. Device
+ * names longer than kDeviceNameLength are cut off.
+ */
+size_t EncodeBeat(const BeatFields& fields, uint8_t* out, size_t capacity) noexcept;
+size_t EncodeStatus(const StatusFields& fields, uint8_t* out, size_t capacity) noexcept;
+size_t EncodeKeepAlive(const KeepAliveFields& fields, uint8_t* out, size_t capacity) noexcept;
+size_t EncodeSyncControl(uint8_t device_number, std::string_view device_name,
+                         SyncCommand command, uint8_t* out, size_t capacity) noexcept;
+size_t EncodeMasterHandoffRequest(uint8_t device_number, std::string_view device_name,
+                                  uint8_t* out, size_t capacity) noexcept;
+size_t EncodeMasterHandoffResponse(uint8_t device_number, std::string_view device_name,
+                                   bool accepted, uint8_t* out, size_t capacity) noexcept;
+size_t EncodePosition(const PositionInfo& info, std::string_view device_name, uint8_t* out,
+                      size_t capacity) noexcept;
+size_t EncodeMixerStatus(uint8_t device_number, std::string_view device_name, uint32_t bpm,
+                         uint8_t beat_within_bar, bool is_master, uint8_t* out,
+                         size_t capacity) noexcept;
+size_t EncodeOnAir(const OnAirInfo& info, std::string_view device_name, uint8_t* out,
+                   size_t capacity) noexcept;
+size_t EncodeFaderStart(const FaderStartInfo& info, std::string_view device_name, uint8_t* out,
+                        size_t capacity) noexcept;
+
+/**
+ * Rewrite the per-send fields of a packet already written by EncodeBeat() or
+ * EncodeStatus(): timings, tempo, pitch, beat, flags and the packet counter.
+ * The device number and name are left as encoded, so a sender can keep one
+ * buffer per packet type and patch it before every send.
+ */
+void PatchBeat(const BeatFields& fields, uint8_t* packet) noexcept;
+void PatchStatus(const StatusFields& fields, uint8_t* packet) noexcept;
+
+}  // namespace prolink
@@ -5,11 +5,15 @@
 #include <chrono>
 #include <cstdint>
 #include <functional>
+#include <map>
 #include <memory>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <vector>
 
+#include "prolink/codec.h"
+
 namespace prolink {
 
 class Session;
@@ -31,40 +35,6 @@ size_t GetDeviceRecordCount(Session& session);
 }  // namespace test
 #endif
 
-/**
- * Well-known Pro DJ Link UDP ports.
- */
-constexpr uint16_t kAnnouncePort = 50000;
-constexpr uint16_t kBeatPort = 50001;
-constexpr uint16_t kStatusPort = 50002;
-
-/**
- * Protocol constants used by beat/status parsing.
- */
-constexpr uint8_t kDeviceNameLength = 20;
-constexpr uint32_t kNeutralPitch = 0x100000;
-
-/**
- * Packet type identifiers used in the first byte after the magic header.
- */
-enum class PacketType : uint8_t {
-  kDeviceKeepAlive = 0x06,
-  kCdjStatus = 0x0a,
-  kMasterHandoffRequest = 0x26,
-  kMasterHandoffResponse = 0x27,
-  kBeat = 0x28,
-  kSyncControl = 0x2a,
-};
-
-/**
- * Sync control commands (packet type 0x2a).
- */
-enum class SyncCommand : uint8_t {
-  kEnableSync = 0x10,
-  kDisableSync = 0x20,
-  kBecomeMaster = 0x01,
-};
-
 /**
  * Basic device discovery information from keep-alive packets.
  */
@@ -81,6 +51,11 @@ struct DeviceInfo {
   std::array<uint8_t, 6> mac_address = {0, 0, 0, 0, 0, 0};
   /// Last time a packet was observed from this device.
   std::chrono::steady_clock::time_point last_seen;
+  /// Kernel receive timestamp of the latest packet from this device.
+  std::chrono::steady_clock::time_point receive_time;
+  /// Index into Config::interfaces of the interface the latest packet
+  /// arrived on (0 for single-interface sessions).
+  uint8_t interface_index = 0;
 };
 
 /**
@@ -97,6 +72,50 @@ struct DeviceEvent {
   DeviceInfo device;
 };
 
+/**
+ * Delay from kernel receive time to the start of packet handling (callback
+ * dispatch), accumulated per packet type.
+ */
+struct LatencyMetrics {
+  uint64_t count = 0;
+  uint64_t total_ns = 0;
+  uint64_t max_ns = 0;
+
+  /// Mean latency in microseconds (0 if nothing was recorded).
+  double average_us() const;
+};
+
+/**
+ * Packets shed by the rate limiter for one source.
+ */
+struct RateLimitedSource {
+  /// Source IPv4 address of the datagrams.
+  std::string source_ip;
+  /// Device number field of the datagrams.
+  uint8_t device_number = 0;
+  PacketType packet_type = PacketType::kCdjStatus;
+  uint64_t dropped = 0;
+};
+
+/**
+ * Receive queue state of one listening socket.
+ */
+struct SocketMetrics {
+  /// Local UDP port (50000, 50001 or 50002).
+  uint16_t port = 0;
+  /// Kernel drop counter for this socket (Linux SO_MEMINFO), read when the
+  /// metrics are taken. Counts receive queue overflows and kernel filter
+  /// rejects.
+  uint64_t kernel_drops = 0;
+  /// Bytes currently waiting in the receive queue (kernel accounting, which
+  /// includes per-datagram overhead on Linux).
+  uint64_t queued_bytes = 0;
+  /// Receive buffer size granted by the kernel (SO_RCVBUF).
+  uint64_t recv_buffer_bytes = 0;
+  /// Index into Config::interfaces of the interface this socket serves.
+  uint8_t interface_index = 0;
+};
+
 /**
  * Lightweight counters for packet flow and error reporting.
  */
@@ -106,6 +125,47 @@ struct SessionMetrics {
   uint64_t parse_errors = 0;
   uint64_t send_errors = 0;
   uint64_t callback_exceptions = 0;
+  /// Datagrams read from the receive sockets (before header validation).
+  uint64_t datagrams_received = 0;
+  /// Receive thread wakeups that found at least one readable socket.
+  uint64_t receive_wakeups = 0;
+  /// Frames dropped by the kernel because the monitor ring was full.
+  uint64_t monitor_drops = 0;
+  /// Datagrams discarded in the kernel on the listening sockets (Linux
+  /// SO_MEMINFO). The kernel keeps one drop counter per socket for both
+  /// socket filter rejects (Config::kernel_filter) and receive queue
+  /// overflows, so this is their sum. The same counter is reported per socket
+  /// in SocketMetrics::kernel_drops; growth on a socket whose queued_bytes is
+  /// near recv_buffer_bytes points to overflows.
+  uint64_t kernel_drops = 0;
+  /// Datagrams that reached userspace but were rejected (bad header, short
+  /// packet, or a packet type this library does not handle).
+  uint64_t userspace_rejected = 0;
+  /// Listening sockets while the session is running (empty in replay and
+  /// monitor modes).
+  std::vector<SocketMetrics> sockets;
+  /// Beat packet handling latency.
+  LatencyMetrics beat_latency;
+  /// Status packet handling latency.
+  LatencyMetrics status_latency;
+  /// Datagrams larger than the receive buffer for their port. They are
+  /// dropped without parsing and do not count as parse errors.
+  uint64_t truncated_packets = 0;
+  /// truncated_packets broken down by packet type byte.
+  std::map<uint8_t, uint64_t> truncated_by_type;
+  /// Datagrams shed by Config::rate_limits before parsing.
+  uint64_t rate_limited = 0;
+  /// rate_limited broken down by source address, device, and packet type.
+  std::vector<RateLimitedSource> rate_limited_sources;
+  /// Copies of a packet dropped because it already arrived on another
+  /// interface (multi-interface sessions only).
+  uint64_t duplicates_dropped = 0;
+  /// Sync control and master handoff packets broadcast because no keep-alive
+  /// from the target device had been seen yet.
+  uint64_t broadcast_fallbacks = 0;
+
+  /// Average number of datagrams drained per receive wakeup.
+  double average_packets_per_wakeup() const;
 };
 
 /**
@@ -126,6 +186,10 @@ struct BeatInfo {
   uint32_t next_beat_ms = 0;
   /// Time to next bar in ms at normal speed.
   uint32_t next_bar_ms = 0;
+  /// Kernel receive timestamp mapped to the steady clock.
+  std::chrono::steady_clock::time_point receive_time;
+  /// Index into Config::interfaces of the ingress interface.
+  uint8_t interface_index = 0;
 
   /// Compute effective BPM applying pitch to the track BPM.
   double effective_bpm() const;
@@ -155,11 +219,174 @@ struct StatusInfo {
   bool is_synced = false;
   /// Whether this device reports itself as playing.
   bool is_playing = false;
+  /// Kernel receive timestamp mapped to the steady clock.
+  std::chrono::steady_clock::time_point receive_time;
+  /// Index into Config::interfaces of the ingress interface.
+  uint8_t interface_index = 0;
+
+  /// kStatusField* groups decoded below; the rest keep their defaults.
+  uint32_t fields = kStatusFieldsCore;
+
+  /// Player the loaded track was loaded from (kStatusFieldTrack).
+  uint8_t track_source_player = 0;
+  TrackSourceSlot track_source_slot = TrackSourceSlot::kNoTrack;
+  TrackType track_type = TrackType::kNoTrack;
+  /// rekordbox database id of the loaded track, 0 if none.
+  uint32_t rekordbox_id = 0;
+  /// Position of the track in its playlist or on the CD.
+  uint16_t track_number = 0;
+
+  /// Transport state (kStatusFieldPlayState).
+  PlayState play_state = PlayState::kNoTrack;
+  /// Raw motor state (0x8b) and playing-forward state (0x9d) bytes.
+  uint8_t play_state2 = 0;
+  uint8_t play_state3 = 0;
+  /// Whether the mixer reports this player's channel as on air.
+  bool is_on_air = false;
+  /// Whether the player's BPM-sync flag is set.
+  bool is_bpm_synced = false;
+
+  /// Firmware version string, e.g. "1.43" (kStatusFieldCounters).
+  std::string firmware_version;
+  /// Counter bumped each time the player takes or gives up sync.
+  uint32_t sync_counter = 0;
+  /// Beats until the next cue point, or kNoUpcomingCue.
+  uint16_t beats_until_cue = kNoUpcomingCue;
+  /// Per-player packet counter; only present in the longer nexus packets.
+  std::optional<uint32_t> packet_counter;
 
   /// Compute effective BPM applying pitch to the track BPM, if available.
   std::optional<double> effective_bpm() const;
 };
 
+/**
+ * Mixer status packet data (type 0x29 on port 50002).
+ */
+struct MixerStatusInfo {
+  /// Device number of the mixer (0x21 on typical hardware).
+  uint8_t device_number = 0;
+  /// Device name field from the packet (trimmed ASCII).
+  std::string device_name;
+  /// Tempo of the mixer's beat FX clock, BPM * 100, if known.
+  std::optional<uint32_t> bpm;
+  /// Raw pitch value (always neutral on current mixers).
+  uint32_t pitch = kNeutralPitch;
+  /// Beat within the bar (1-4) as reported by the mixer.
+  uint8_t beat_within_bar = 0;
+  /// Device number being handed the master role, or 0xff if none.
+  uint8_t master_handoff_to = 0xff;
+  /// Whether the mixer reports itself as tempo master.
+  bool is_master = false;
+  /// Kernel receive timestamp mapped to the steady clock.
+  std::chrono::steady_clock::time_point receive_time;
+  /// Index into Config::interfaces of the ingress interface.
+  uint8_t interface_index = 0;
+};
+
+/**
+ * Copy the fields of a packet view (prolink/codec.h) into an owning record
+ * that outlives the receive buffer.
+ */
+BeatInfo Materialize(const BeatView& view);
+/// Copies the core fields plus the requested kStatusField* groups.
+StatusInfo Materialize(const StatusView& view, uint32_t fields = kStatusFieldsAll);
+DeviceInfo Materialize(const KeepAliveView& view);
+MixerStatusInfo Materialize(const MixerStatusView& view);
+
+/**
+ * A received datagram as passed to Session::RawPacketCallback. The bytes
+ * point into the receive buffer and are valid only during the callback.
+ */
+struct RawPacket {
+  const uint8_t* data = nullptr;
+  size_t size = 0;
+  /// Sender IPv4 address in network byte order.
+  uint32_t source_ip = 0;
+  /// Sender UDP port.
+  uint16_t source_port = 0;
+  /// Pro DJ Link port the datagram arrived on (kAnnouncePort, kBeatPort or
+  /// kStatusPort).
+  uint16_t local_port = 0;
+  /// Config::interfaces index of the receiving socket.
+  uint8_t interface_index = 0;
+  /// The datagram did not fit the receive buffer and was cut short.
+  bool truncated = false;
+  std::chrono::steady_clock::time_point receive_time;
+};
+
+/**
+ * Readiness backend used by the receive thread.
+ */
+enum class RecvBackend {
+  /// epoll on Linux, select() elsewhere.
+  kAuto,
+  /// Portable select() with a self-pipe wakeup.
+  kSelect,
+  /// Edge-triggered epoll with an eventfd wakeup (Linux only).
+  kEpoll,
+  /// io_uring multishot receives and queued sends (requires PROLINK_ENABLE_IO_URING).
+  kIoUring,
+  /// Spin on non-blocking batched reads instead of sleeping; dedicates the
+  /// receive thread to a core in exchange for lower wakeup latency.
+  kBusyPoll,
+};
+
+/**
+ * Idle policy of the RecvBackend::kBusyPoll loop between empty polls.
+ */
+enum class BusyPollBackoff {
+  /// Re-poll immediately.
+  kSpin,
+  /// Issue a CPU pause hint between polls (frees pipeline resources for an
+  /// SMT sibling at a small latency cost).
+  kPause,
+  /// Pause, then yield the thread to the scheduler after a run of empty polls.
+  kYield,
+};
+
+/**
+ * Token bucket parameters for one packet type (see Config::rate_limits).
+ */
+struct RateLimit {
+  /// Sustained packets per second accepted from one source.
+  double packets_per_second = 0.0;
+  /// Packets accepted back to back before limiting starts.
+  double burst = 1.0;
+};
+
+/**
+ * One network interface of a multi-interface session (see Config::interfaces).
+ */
+struct InterfaceConfig {
+  /// Network device to bind to (SO_BINDTODEVICE, Linux). Empty binds by
+  /// address only.
+  std::string name;
+  /// Local bind address for this interface's sockets.
+  std::string bind_address = "0.0.0.0";
+  /// Broadcast address used for beat/status packets on this interface.
+  std::string broadcast_address = "255.255.255.255";
+  /// Broadcast address used for announce packets (empty uses broadcast_address).
+  std::string announce_address;
+  /// IPv4 address announced on this interface (empty uses Config::device_ip).
+  std::string device_ip;
+};
+
+/**
+ * Addresses a session currently uses on one interface (see Session::GetInterfaces).
+ */
+struct NetworkInterfaceInfo {
+  /// Host interface the addresses were resolved from (empty if configured by hand).
+  std::string name;
+  /// IPv4 address announced on this interface (empty disables announces).
+  std::string device_ip;
+  /// MAC address announced on this interface.
+  std::array<uint8_t, 6> mac_address = {0, 0, 0, 0, 0, 0};
+  /// Destination of beat and status broadcasts.
+  std::string broadcast_address;
+  /// Destination of announce broadcasts.
+  std::string announce_address;
+};
+
 /**
  * Session configuration for sockets, identity, and timing behavior.
  */
@@ -183,6 +410,21 @@ struct Config {
   std::string broadcast_address = "255.255.255.255";
   /// Broadcast address used for announce packets.
   std::string announce_address = "255.255.255.255";
+  /// Interfaces to open the 50000-50002 sockets on (at most 8). Empty uses
+  /// a single interface built from bind_address, broadcast_address,
+  /// announce_address, and device_ip. Beats, status, and announces go out of
+  /// every interface; a packet that arrives on more than one interface is
+  /// delivered once.
+  std::vector<InterfaceConfig> interfaces;
+  /// Fill device_ip, mac_address, broadcast_address, and announce_address
+  /// from the host's network interfaces at Start() and track address changes
+  /// while running. Only fields left at their defaults are filled.
+  bool auto_network = false;
+  /// Interface used by auto_network: a name ("eth0") or an IPv4 subnet
+  /// ("192.168.1.0/24"). Empty picks the interface holding bind_address, else
+  /// the one on which Pro DJ Link devices are seen, else the first
+  /// broadcast-capable interface. InterfaceConfig::name takes precedence.
+  std::string network_interface;
 
   /// Status interval in milliseconds (CDJs send ~200 ms).
   int status_interval_ms = 200;
@@ -190,6 +432,55 @@ struct Config {
   int announce_interval_ms = 1500;
   /// Beats per bar for local beat clock.
   int beats_per_bar = 4;
+  /// Maximum datagrams read per receive syscall (recvmmsg on Linux, 1-1024).
+  int recv_batch_size = 16;
+  /// Readiness backend for the receive thread.
+  RecvBackend recv_backend = RecvBackend::kAuto;
+  /// Idle policy for RecvBackend::kBusyPoll.
+  BusyPollBackoff busy_poll_backoff = BusyPollBackoff::kPause;
+  /// Per packet type token buckets keyed by source address and device number.
+  /// Excess packets are dropped before parsing. Beats are never limited.
+  /// Players send status about every 200 ms and keep-alives about every
+  /// 1.5 s, so the defaults only engage on floods. Up to 4096 sources are
+  /// tracked; once that many are active, packets from new sources are dropped
+  /// until buckets idle for 10 s are evicted every device_prune_interval.
+  std::map<PacketType, RateLimit> rate_limits = {
+      {PacketType::kCdjStatus, {50.0, 25.0}},
+      {PacketType::kDeviceKeepAlive, {10.0, 10.0}},
+  };
+  /// Receive port 50001 (beats, sync control, master handoff) on a dedicated
+  /// thread so slow status, keep-alive, or device event handling cannot delay
+  /// beats. Ignored in replay and monitor modes; not supported with
+  /// RecvBackend::kIoUring.
+  bool beat_lane = false;
+  /// SCHED_FIFO priority (1-99) for the beat lane thread; 0 keeps the default
+  /// policy. Needs CAP_SYS_NICE or RLIMIT_RTPRIO, otherwise the failure is
+  /// logged and the lane runs at normal priority.
+  int beat_lane_priority = 0;
+  /// SO_BUSY_POLL budget in microseconds for RecvBackend::kBusyPoll (Linux;
+  /// 0 leaves the socket option unset). Raising it above net.core.busy_read
+  /// requires CAP_NET_ADMIN; without it the session spins in userspace only.
+  int busy_poll_us = 50;
+  /// Attach a kernel socket filter (Linux) that drops datagrams without the
+  /// Pro DJ Link header, expected packet type, and minimum length.
+  bool kernel_filter = true;
+  /// Receive buffer size per listening socket in bytes (0 keeps the system
+  /// default). Uses SO_RCVBUFFORCE when privileged, otherwise capped by
+  /// net.core.rmem_max.
+  int recv_buffer_bytes = 0;
+  /// Send buffer size per socket in bytes (0 keeps the system default).
+  int send_buffer_bytes = 0;
+  /// Send sync control and master handoff packets through a UDP socket
+  /// connect()ed to each device that sent a keep-alive instead of sendto()
+  /// on the beat socket. The connected sockets use an ephemeral source port;
+  /// there is at most one per device number, reused when an expired device
+  /// returns at the same address.
+  bool connect_control_sockets = false;
+  /// Decode received packets. When false, datagrams only reach the raw
+  /// packet callback and capture_file: no rate limiting, device tracking,
+  /// beat/status callbacks, or tempo master tracking. Incompatible with
+  /// follow_master.
+  bool parse_packets = true;
 
   /// Base tempo for the local beat clock (BPM).
   double tempo_bpm = 120.0;
@@ -214,10 +505,16 @@ struct Config {
   /// Optional log callback (defaults to stderr).
   LogCallback log_callback;
 
-  /// Optional packet capture file (binary).
+  /// Optional packet capture file (binary, versioned; format in the README).
   std::string capture_file;
-  /// Optional packet replay file (binary).
+  /// Optional packet replay file. Reads versioned captures and headerless
+  /// legacy captures.
   std::string replay_file;
+  /// Optional interface for passive monitoring (Linux, needs CAP_NET_RAW).
+  /// When set, UDP 50000-50002 traffic on this interface (including unicast
+  /// between other devices on a mirror port or bridge) is read from an
+  /// AF_PACKET ring instead of the bound sockets.
+  std::string monitor_interface;
 
   /// Retry interval for tempo master handoff requests.
   std::chrono::milliseconds master_request_retry_interval{1000};
@@ -249,6 +546,14 @@ class Session {
   using StatusCallback = std::function<void(const StatusInfo&)>;
   using DeviceCallback = std::function<void(const DeviceInfo&)>;
   using DeviceEventCallback = std::function<void(const DeviceEvent&)>;
+  using BeatViewCallback = std::function<void(const BeatView&)>;
+  using StatusViewCallback = std::function<void(const StatusView&)>;
+  using KeepAliveViewCallback = std::function<void(const KeepAliveView&)>;
+  using RawPacketCallback = std::function<void(const RawPacket&)>;
+  using PositionCallback = std::function<void(const PositionInfo&)>;
+  using MixerStatusCallback = std::function<void(const MixerStatusInfo&)>;
+  using OnAirCallback = std::function<void(const OnAirInfo&)>;
+  using FaderStartCallback = std::function<void(const FaderStartInfo&)>;
 
   /// Construct a session with the provided configuration.
   explicit Session(Config config);
@@ -265,12 +570,35 @@ class Session {
 
   /// Set callback invoked for each parsed beat packet.
   void SetBeatCallback(BeatCallback cb);
-  /// Set callback invoked for each parsed status packet.
-  void SetStatusCallback(StatusCallback cb);
+  /// Set callback invoked for each parsed status packet. Only the
+  /// kStatusField* groups in `fields` are decoded into the StatusInfo.
+  void SetStatusCallback(StatusCallback cb, uint32_t fields = kStatusFieldsAll);
   /// Set callback invoked when a device keep-alive is observed/updated.
   void SetDeviceCallback(DeviceCallback cb);
   /// Set callback invoked on device lifecycle events (seen/updated/expired).
   void SetDeviceEventCallback(DeviceEventCallback cb);
+  /// Set callback invoked with a view of each beat packet. Runs before the
+  /// BeatCallback; a BeatInfo is only built when a BeatCallback is set.
+  void SetBeatViewCallback(BeatViewCallback cb);
+  /// Set callback invoked with a view of each status packet. Runs before the
+  /// StatusCallback; a StatusInfo is only built when needed.
+  void SetStatusViewCallback(StatusViewCallback cb);
+  /// Set callback invoked with a view of each keep-alive packet.
+  void SetKeepAliveViewCallback(KeepAliveViewCallback cb);
+  /// Set callback invoked for each precise position packet.
+  void SetPositionCallback(PositionCallback cb);
+  /// Set callback invoked for each mixer status packet.
+  void SetMixerStatusCallback(MixerStatusCallback cb);
+  /// Set callback invoked for each channels-on-air packet, after the
+  /// IsOnAir() table has been updated.
+  void SetOnAirCallback(OnAirCallback cb);
+  /// Set callback invoked for each fader start packet, after the
+  /// GetFaderStart() table has been updated.
+  void SetFaderStartCallback(FaderStartCallback cb);
+  /// Set callback invoked with every datagram read from the network, before
+  /// any validation or parsing (not called in replay mode). Runs on the
+  /// receive thread, so keep it short.
+  void SetRawPacketCallback(RawPacketCallback cb);
 
   /// Update local tempo (BPM) for beat/status sending.
   void SetTempo(double bpm);
@@ -298,8 +626,20 @@ class Session {
 
   /// Return the last known tempo master status, if any.
   std::optional<StatusInfo> GetTempoMaster() const;
+  /// Return the latest precise position received from a player, if any.
+  /// Lock-free: safe to poll from a render loop while packets arrive.
+  std::optional<PositionInfo> GetLatestPosition(uint8_t device_number) const;
+  /// Return whether the mixer reports player `channel` (1-4) on air, or
+  /// std::nullopt before any channels-on-air packet. Lock-free.
+  std::optional<bool> IsOnAir(uint8_t channel) const;
+  /// Return the last fader start command for player `channel` (1-4), or
+  /// std::nullopt if none was received. Lock-free.
+  std::optional<FaderStartCommand> GetFaderStart(uint8_t channel) const;
   /// Return the list of devices discovered via keep-alive packets.
   std::vector<DeviceInfo> GetDevices() const;
+  /// Return the addresses in use on each interface (one per Config::interfaces
+  /// entry, or one for single-interface sessions).
+  std::vector<NetworkInterfaceInfo> GetInterfaces() const;
   /// Return the last Start() error message, if any.
   std::string GetLastError() const;
   /// Return metrics for packets, errors, and callbacks.
@@ -74,6 +74,25 @@ std::vector<uint8_t> BuildStatusPacket(uint8_t device_number,
                                        bool is_playing,
                                        uint8_t master_handoff_to);
 
+std::vector<uint8_t> BuildPositionPacket(uint8_t device_number,
+                                         const std::string& device_name,
+                                         uint32_t track_length_s,
+                                         uint32_t playhead_ms,
+                                         int32_t pitch,
+                                         uint32_t bpm_x10);
+
+std::vector<uint8_t> BuildMixerStatusPacket(uint8_t device_number,
+                                            const std::string& device_name,
+                                            uint32_t bpm,
+                                            uint8_t beat_within_bar,
+                                            bool is_master);
+
+std::vector<uint8_t> BuildOnAirPacket(uint8_t device_number,
+                                      const std::array<bool, kMixerChannelCount>& on_air);
+
+std::vector<uint8_t> BuildFaderStartPacket(
+    uint8_t device_number, const std::array<FaderStartCommand, kMixerChannelCount>& commands);
+
 std::vector<uint8_t> BuildKeepAlivePacket(uint8_t device_number,
                                           uint8_t device_type,
                                           const std::string& device_name,
@@ -82,8 +101,15 @@ std::vector<uint8_t> BuildKeepAlivePacket(uint8_t device_number,
 
 bool ParseBeatPacket(const std::vector<uint8_t>& data, BeatInfo* out);
 bool ParseStatusPacket(const std::vector<uint8_t>& data, StatusInfo* out);
+bool ParsePositionPacket(const std::vector<uint8_t>& data, PositionInfo* out);
+bool ParseMixerStatusPacket(const std::vector<uint8_t>& data, MixerStatusInfo* out);
 bool ParseKeepAlivePacket(const std::vector<uint8_t>& data, DeviceInfo* out);
 
+// Run one classifier implementation over `datagrams` received on `port`.
+// Returns false if this build or CPU does not provide it.
+bool ClassifyWith(ClassifierIsa isa, const std::vector<std::vector<uint8_t>>& datagrams,
+                  std::vector<ClassifiedDatagram>* out, uint16_t port = kAnyPort);
+
 void InjectKeepAlive(Session& session,
                      uint8_t device_number,
                      uint8_t device_type,
@@ -0,0 +1,707 @@
+// Pro DJ Link packet codec: views, classifier, batch parser and encoders.
+// Built as prolink_codec without exceptions; nothing here allocates.
+#include "codec_internal.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <optional>
+#include <string_view>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define PROLINK_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+namespace prolink {
+namespace internal {
+namespace {
+
+void ClassifyBatchScalar(const uint8_t* const* data, const size_t* lengths, size_t count,
+                         uint16_t port, DatagramClass* out) {
+  const MinLengthTable& min_lengths = MinLengthsForPort(port);
+  for (size_t i = 0; i < count; ++i) {
+    out[i] = ClassifyDatagram(data[i], lengths[i], min_lengths);
+  }
+}
+
+#ifdef PROLINK_X86_SIMD
+bool CpuHasAvx2() {
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("avx2");
+}
+
+// The vector paths load 16 bytes per datagram; shorter ones go scalar.
+constexpr size_t kSimdLoadSize = 16;
+constexpr int kMagicLaneMask = (1 << kHeaderSize) - 1;
+constexpr uint8_t kMagicLanes[kSimdLoadSize] = {
+    0x51, 0x73, 0x70, 0x74, 0x31, 0x57, 0x6d, 0x4a, 0x4f, 0x4c,
+};
+
+__m128i LoadSimd(const uint8_t* data) {
+  return _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+}
+
+void ClassifyBatchSse2(const uint8_t* const* data, const size_t* lengths, size_t count,
+                       uint16_t port, DatagramClass* out) {
+  const MinLengthTable& min_lengths = MinLengthsForPort(port);
+  const __m128i magic = LoadSimd(kMagicLanes);
+  for (size_t i = 0; i < count; ++i) {
+    if (lengths[i] < kSimdLoadSize) {
+      out[i] = ClassifyDatagram(data[i], lengths[i], min_lengths);
+      continue;
+    }
+    const int lanes = _mm_movemask_epi8(_mm_cmpeq_epi8(LoadSimd(data[i]), magic));
+    out[i] = FinishClass((lanes & kMagicLaneMask) == kMagicLaneMask, data[i], lengths[i],
+                         min_lengths);
+  }
+}
+
+// Two datagrams per 256-bit compare.
+__attribute__((target("avx2"))) void ClassifyBatchAvx2(const uint8_t* const* data,
+                                                       const size_t* lengths, size_t count,
+                                                       uint16_t port, DatagramClass* out) {
+  const MinLengthTable& min_lengths = MinLengthsForPort(port);
+  const __m256i magic = _mm256_broadcastsi128_si256(LoadSimd(kMagicLanes));
+  size_t i = 0;
+  for (; i + 1 < count; i += 2) {
+    if (lengths[i] < kSimdLoadSize || lengths[i + 1] < kSimdLoadSize) {
+      out[i] = ClassifyDatagram(data[i], lengths[i], min_lengths);
+      out[i + 1] = ClassifyDatagram(data[i + 1], lengths[i + 1], min_lengths);
+      continue;
+    }
+    const __m256i pair = _mm256_inserti128_si256(_mm256_castsi128_si256(LoadSimd(data[i])),
+                                                 LoadSimd(data[i + 1]), 1);
+    const uint32_t lanes =
+        static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(pair, magic)));
+    out[i] = FinishClass((lanes & kMagicLaneMask) == kMagicLaneMask, data[i], lengths[i],
+                         min_lengths);
+    out[i + 1] = FinishClass(((lanes >> 16) & kMagicLaneMask) == kMagicLaneMask, data[i + 1],
+                             lengths[i + 1], min_lengths);
+  }
+  if (i < count) {
+    out[i] = ClassifyDatagram(data[i], lengths[i], min_lengths);
+  }
+}
+#endif
+
+ClassifierIsa DetectClassifierIsa() {
+#ifdef PROLINK_X86_SIMD
+  return CpuHasAvx2() ? ClassifierIsa::kAvx2 : ClassifierIsa::kSse2;
+#else
+  return ClassifierIsa::kScalar;
+#endif
+}
+
+}  // namespace
+
+// Batch classifier for `isa`, or nullptr if this build or CPU lacks it.
+ClassifyBatchFn ClassifierFor(ClassifierIsa isa) {
+  switch (isa) {
+    case ClassifierIsa::kScalar:
+      return ClassifyBatchScalar;
+#ifdef PROLINK_X86_SIMD
+    case ClassifierIsa::kSse2:
+      return ClassifyBatchSse2;
+    case ClassifierIsa::kAvx2:
+      return CpuHasAvx2() ? ClassifyBatchAvx2 : nullptr;
+#endif
+    default:
+      return nullptr;
+  }
+}
+
+void ClassifyBatch(const uint8_t* const* data, const size_t* lengths, size_t count,
+                   uint16_t port, DatagramClass* out) {
+  static const ClassifyBatchFn classify = ClassifierFor(DetectClassifierIsa());
+  classify(data, lengths, count, port, out);
+}
+
+// Keep the accepted datagrams as (index, type) entries in input order,
+// numbering them from `first_index`.
+size_t CompactAccepted(const DatagramClass* classes, size_t count, size_t first_index,
+                       ClassifiedDatagram* out) {
+  size_t accepted = 0;
+  for (size_t i = 0; i < count; ++i) {
+    if (classes[i].verdict == DatagramVerdict::kAccepted) {
+      out[accepted].index = static_cast<uint32_t>(first_index + i);
+      out[accepted].type = classes[i].type;
+      ++accepted;
+    }
+  }
+  return accepted;
+}
+
+// Trimmed view of the 20-byte device name field at a specific offset.
+std::string_view DeviceNameViewAt(const uint8_t* data, size_t length, size_t offset) {
+  if (length < offset + kDeviceNameLength) {
+    return {};
+  }
+  std::string_view name(reinterpret_cast<const char*>(data + offset), kDeviceNameLength);
+  const size_t null_pos = name.find('\0');
+  if (null_pos != std::string_view::npos) {
+    name = name.substr(0, null_pos);
+  }
+  // Device names are space-padded in packets; preserve intentional leading spaces.
+  while (!name.empty() && name.back() == ' ') {
+    name.remove_suffix(1);
+  }
+  return name;
+}
+
+// Convert pitch value to a multiplier (1.0 at neutral pitch).
+double PitchToMultiplier(uint32_t pitch) {
+  return pitch / static_cast<double>(kNeutralPitch);
+}
+
+}  // namespace internal
+
+using namespace internal;
+
+double PositionInfo::pitch_percent() const { return pitch / 100.0; }
+
+double PositionInfo::effective_bpm() const { return bpm / 100.0; }
+
+uint8_t PacketView::device_number() const {
+  return length_ > kOffsetDeviceNumber ? data_[kOffsetDeviceNumber] : 0;
+}
+
+std::string_view PacketView::device_name() const {
+  return DeviceNameViewAt(data_, length_, kDeviceNameOffset);
+}
+
+bool BeatView::valid() const {
+  return data_ && length_ >= BeatLayout::kSize && HasHeader(data_, length_) &&
+         data_[kPacketTypeOffset] == static_cast<uint8_t>(PacketType::kBeat);
+}
+
+uint32_t BeatView::bpm() const { return BeatLayout::Bpm::Read(data_); }
+
+uint32_t BeatView::pitch() const { return BeatLayout::Pitch::Read(data_); }
+
+uint8_t BeatView::beat_within_bar() const {
+  // Sanitize to the valid range (1-8, common values are 1-4).
+  const uint8_t beat = BeatLayout::BeatWithinBar::Read(data_);
+  return beat < 1 || beat > 8 ? 1 : beat;
+}
+
+uint32_t BeatView::next_beat_ms() const { return BeatLayout::NextBeat::Read(data_); }
+
+uint32_t BeatView::next_bar_ms() const { return BeatLayout::NextBar::Read(data_); }
+
+double BeatView::effective_bpm() const {
+  return bpm() * PitchToMultiplier(pitch()) / 100.0;
+}
+
+bool StatusView::valid() const {
+  return data_ && length_ >= StatusLayout::kMinimumSize && HasHeader(data_, length_) &&
+         data_[kPacketTypeOffset] == static_cast<uint8_t>(PacketType::kCdjStatus);
+}
+
+std::optional<uint32_t> StatusView::bpm() const {
+  const uint16_t raw = StatusLayout::Bpm::Read(data_);
+  if (raw == kMaxUint16) {
+    return std::nullopt;
+  }
+  return raw;
+}
+
+uint32_t StatusView::pitch() const { return StatusLayout::Pitch::Read(data_); }
+
+std::optional<uint32_t> StatusView::beat() const {
+  const uint32_t raw = StatusLayout::BeatNumber::Read(data_);
+  if (raw == kMaxUint32) {
+    return std::nullopt;
+  }
+  return raw;
+}
+
+uint8_t StatusView::beat_within_bar() const {
+  const uint8_t beat = StatusLayout::BeatWithinBar::Read(data_);
+  return beat < 1 || beat > 8 ? 1 : beat;
+}
+
+uint8_t StatusView::master_handoff_to() const {
+  return StatusLayout::MasterHandoff::Read(data_);
+}
+
+bool StatusView::is_master() const {
+  return (StatusLayout::Flags::Read(data_) & kStatusFlagMaster) != 0;
+}
+
+bool StatusView::is_synced() const {
+  return (StatusLayout::Flags::Read(data_) & kStatusFlagSynced) != 0;
+}
+
+bool StatusView::is_playing() const {
+  return (StatusLayout::Flags::Read(data_) & kStatusFlagPlaying) != 0;
+}
+
+std::optional<double> StatusView::effective_bpm() const {
+  const auto raw = bpm();
+  if (!raw.has_value()) {
+    return std::nullopt;
+  }
+  return raw.value() * PitchToMultiplier(pitch()) / 100.0;
+}
+
+uint8_t StatusView::track_source_player() const {
+  return StatusLayout::TrackSourcePlayer::Read(data_);
+}
+
+TrackSourceSlot StatusView::track_source_slot() const {
+  return static_cast<TrackSourceSlot>(StatusLayout::TrackSourceSlot::Read(data_));
+}
+
+TrackType StatusView::track_type() const {
+  return static_cast<TrackType>(StatusLayout::TrackType::Read(data_));
+}
+
+uint32_t StatusView::rekordbox_id() const { return StatusLayout::RekordboxId::Read(data_); }
+
+uint16_t StatusView::track_number() const { return StatusLayout::TrackNumber::Read(data_); }
+
+PlayState StatusView::play_state() const {
+  return static_cast<PlayState>(StatusLayout::PlayState::Read(data_));
+}
+
+uint8_t StatusView::play_state2() const { return StatusLayout::PlayState2::Read(data_); }
+
+uint8_t StatusView::play_state3() const { return StatusLayout::PlayState3::Read(data_); }
+
+bool StatusView::is_on_air() const {
+  return (StatusLayout::Flags::Read(data_) & kStatusFlagOnAir) != 0;
+}
+
+bool StatusView::is_bpm_synced() const {
+  return (StatusLayout::Flags::Read(data_) & kStatusFlagBpmSync) != 0;
+}
+
+std::string_view StatusView::firmware_version() const {
+  std::string_view version(
+      reinterpret_cast<const char*>(data_ + StatusLayout::FirmwareVersion::kOffset),
+      StatusLayout::FirmwareVersion::kWidth);
+  const size_t null_pos = version.find('\0');
+  if (null_pos != std::string_view::npos) {
+    version = version.substr(0, null_pos);
+  }
+  while (!version.empty() && version.back() == ' ') {
+    version.remove_suffix(1);
+  }
+  return version;
+}
+
+uint32_t StatusView::sync_counter() const { return StatusLayout::SyncCounter::Read(data_); }
+
+uint16_t StatusView::beats_until_cue() const {
+  return StatusLayout::BeatsUntilCue::Read(data_);
+}
+
+std::optional<uint32_t> StatusView::packet_counter() const {
+  if (length_ < StatusLayout::PacketCounter::kEnd) {
+    return std::nullopt;
+  }
+  return StatusLayout::PacketCounter::Read(data_);
+}
+
+bool KeepAliveView::valid() const {
+  return data_ && length_ >= KeepAliveLayout::kSize && HasHeader(data_, length_) &&
+         data_[kPacketTypeOffset] == static_cast<uint8_t>(PacketType::kDeviceKeepAlive);
+}
+
+uint8_t KeepAliveView::device_number() const {
+  return KeepAliveLayout::DeviceNumber::Read(data_);
+}
+
+std::string_view KeepAliveView::device_name() const {
+  const std::string_view name = PacketView::device_name();
+  if (!name.empty()) {
+    return name;
+  }
+  return DeviceNameViewAt(data_, length_, KeepAliveLayout::DeviceName::kOffset);
+}
+
+uint8_t KeepAliveView::device_type() const { return KeepAliveLayout::DeviceType::Read(data_); }
+
+std::array<uint8_t, 6> KeepAliveView::mac_address() const {
+  std::array<uint8_t, 6> mac{};
+  KeepAliveLayout::MacAddress::Read(data_, mac.data());
+  return mac;
+}
+
+uint32_t KeepAliveView::ip_address() const {
+  uint32_t ip = 0;
+  KeepAliveLayout::IpAddress::Read(data_, &ip);
+  return ip;
+}
+
+bool MixerStatusView::valid() const {
+  return data_ && length_ >= MixerStatusLayout::kSize && HasHeader(data_, length_) &&
+         data_[kPacketTypeOffset] == static_cast<uint8_t>(PacketType::kMixerStatus);
+}
+
+std::optional<uint32_t> MixerStatusView::bpm() const {
+  const uint16_t raw = MixerStatusLayout::Bpm::Read(data_);
+  if (raw == kMaxUint16) {
+    return std::nullopt;
+  }
+  return raw;
+}
+
+uint32_t MixerStatusView::pitch() const { return MixerStatusLayout::Pitch::Read(data_); }
+
+uint8_t MixerStatusView::beat_within_bar() const {
+  return MixerStatusLayout::BeatWithinBar::Read(data_);
+}
+
+uint8_t MixerStatusView::master_handoff_to() const {
+  return MixerStatusLayout::MasterHandoff::Read(data_);
+}
+
+bool MixerStatusView::is_master() const {
+  return (MixerStatusLayout::Flags::Read(data_) & kStatusFlagMaster) != 0;
+}
+
+// Decode a CDJ-3000 precise position packet (0x3c bytes) into PositionInfo.
+bool DecodePosition(const uint8_t* data, size_t length, PositionInfo* out) noexcept {
+  if (!out || !data || length < PositionLayout::kSize || !HasHeader(data, length) ||
+      data[kPacketTypeOffset] != static_cast<uint8_t>(PacketType::kPrecisePosition)) {
+    return false;
+  }
+  out->device_number = PositionLayout::DeviceNumber::Read(data);
+  out->track_length_s = PositionLayout::TrackLength::Read(data);
+  out->playhead_ms = PositionLayout::Playhead::Read(data);
+  out->pitch = static_cast<int32_t>(PositionLayout::Pitch::Read(data));
+  out->bpm = SafeMul(PositionLayout::Bpm::Read(data), 10);
+  return true;
+}
+
+// Decode a channels-on-air packet into OnAirInfo.
+bool DecodeOnAir(const uint8_t* data, size_t length, OnAirInfo* out) noexcept {
+  if (!out || !data || length < MixerChannelLayout::kOnAirSize || !HasHeader(data, length) ||
+      data[kPacketTypeOffset] != static_cast<uint8_t>(PacketType::kChannelsOnAir)) {
+    return false;
+  }
+  uint8_t channels[kMixerChannelCount];
+  MixerChannelLayout::Channels::Read(data, channels);
+  out->device_number = MixerChannelLayout::DeviceNumber::Read(data);
+  for (size_t i = 0; i < kMixerChannelCount; ++i) {
+    out->on_air[i] = channels[i] != 0;
+  }
+  return true;
+}
+
+// Decode a fader start packet into FaderStartInfo.
+bool DecodeFaderStart(const uint8_t* data, size_t length, FaderStartInfo* out) noexcept {
+  if (!out || !data || length < MixerChannelLayout::kFaderStartSize ||
+      !HasHeader(data, length) ||
+      data[kPacketTypeOffset] != static_cast<uint8_t>(PacketType::kFaderStart)) {
+    return false;
+  }
+  uint8_t channels[kMixerChannelCount];
+  MixerChannelLayout::Channels::Read(data, channels);
+  for (size_t i = 0; i < kMixerChannelCount; ++i) {
+    if (channels[i] > static_cast<uint8_t>(FaderStartCommand::kNoChange)) {
+      return false;
+    }
+  }
+  out->device_number = MixerChannelLayout::DeviceNumber::Read(data);
+  for (size_t i = 0; i < kMixerChannelCount; ++i) {
+    out->commands[i] = static_cast<FaderStartCommand>(channels[i]);
+  }
+  return true;
+}
+
+namespace {
+
+// Copy a packet image into `out` and write the sender's name. Returns the
+// image size, or 0 if it does not fit.
+template <size_t N>
+size_t EncodeImage(const std::array<uint8_t, N>& image, std::string_view device_name,
+                   uint8_t* out, size_t capacity) {
+  if (!out || capacity < N) {
+    return 0;
+  }
+  std::memcpy(out, image.data(), N);
+  DeviceNameField::Write(out, device_name.data(), device_name.size());
+  return N;
+}
+
+// Sync control or master handoff response, which share a layout.
+size_t EncodeControl(const std::array<uint8_t, ControlLayout::kSize>& image,
+                     uint8_t device_number, std::string_view device_name, uint8_t command,
+                     uint8_t* out, size_t capacity) {
+  const size_t size = EncodeImage(image, device_name, out, capacity);
+  if (size) {
+    ControlLayout::DeviceNumber::Write(out, device_number);
+    ControlLayout::Sender::Write(out, device_number);
+    ControlLayout::Command::Write(out, command);
+  }
+  return size;
+}
+
+static_assert(kBeatImage.size() <= kMaxEncodedPacketSize &&
+                  kStatusImage.size() <= kMaxEncodedPacketSize &&
+                  kKeepAliveImage.size() <= kMaxEncodedPacketSize &&
+                  kPositionImage.size() <= kMaxEncodedPacketSize &&
+                  kMixerStatusImage.size() <= kMaxEncodedPacketSize,
+              "kMaxEncodedPacketSize too small");
+
+}  // namespace
+
+size_t EncodeBeat(const BeatFields& fields, uint8_t* out, size_t capacity) noexcept {
+  const size_t size = EncodeImage(kBeatImage, fields.device_name, out, capacity);
+  if (!size) {
+    return 0;
+  }
+  BeatLayout::DeviceNumber::Write(out, fields.device_number);
+  BeatLayout::DeviceNumber2::Write(out, fields.device_number);
+  PatchBeat(fields, out);
+  return size;
+}
+
+void PatchBeat(const BeatFields& fields, uint8_t* packet) noexcept {
+  BeatLayout::NextBeat::Write(packet, fields.next_beat_ms);
+  BeatLayout::SecondBeat::Write(packet, fields.second_beat_ms);
+  BeatLayout::NextBar::Write(packet, fields.next_bar_ms);
+  BeatLayout::FourthBeat::Write(packet, fields.fourth_beat_ms);
+  BeatLayout::SecondBar::Write(packet, fields.second_bar_ms);
+  BeatLayout::EighthBeat::Write(packet, fields.eighth_beat_ms);
+  BeatLayout::Pitch::Write(packet, fields.pitch);
+  BeatLayout::Bpm::Write(packet, fields.bpm);
+  BeatLayout::BeatWithinBar::Write(packet, fields.beat_within_bar);
+}
+
+size_t EncodeStatus(const StatusFields& fields, uint8_t* out, size_t capacity) noexcept {
+  const size_t size = EncodeImage(kStatusImage, fields.device_name, out, capacity);
+  if (!size) {
+    return 0;
+  }
+  StatusLayout::DeviceNumber::Write(out, fields.device_number);
+  StatusLayout::DeviceNumber2::Write(out, fields.device_number);
+  StatusLayout::TrackSourcePlayer::Write(out, fields.device_number);
+  PatchStatus(fields, out);
+  return size;
+}
+
+void PatchStatus(const StatusFields& fields, uint8_t* packet) noexcept {
+  // Play state bytes as a CDJ reports them while playing or paused.
+  StatusLayout::PlayingFlag::Write(packet, fields.is_playing ? 1 : 0);
+  StatusLayout::PlayState::Write(packet, fields.is_playing ? 3 : 5);
+  StatusLayout::Flags::Write(packet, 0x84 | (fields.is_playing ? kStatusFlagPlaying : 0) |
+                                         (fields.is_master ? kStatusFlagMaster : 0) |
+                                         (fields.is_synced ? kStatusFlagSynced : 0));
+  StatusLayout::PlayState2::Write(packet, fields.is_playing ? 0x7a : 0x7e);
+  StatusLayout::PlayState3::Write(packet, fields.is_playing ? 9 : 1);
+  StatusLayout::MasterFlag::Write(packet, fields.is_master ? 1 : 0);
+  StatusLayout::MasterHandoff::Write(packet, fields.master_handoff_to);
+  StatusLayout::Pitch::Write(packet, fields.pitch);
+  StatusLayout::Bpm::Write(packet, fields.bpm);
+  StatusLayout::BeatNumber::Write(packet, fields.beat);
+  StatusLayout::BeatWithinBar::Write(packet, fields.beat_within_bar);
+  StatusLayout::PacketCounter::Write(packet, fields.packet_counter);
+}
+
+size_t EncodeKeepAlive(const KeepAliveFields& fields, uint8_t* out, size_t capacity) noexcept {
+  if (!out || capacity < kKeepAliveImage.size()) {
+    return 0;
+  }
+  std::memcpy(out, kKeepAliveImage.data(), kKeepAliveImage.size());
+  KeepAliveLayout::DeviceName::Write(out, fields.device_name.data(), fields.device_name.size());
+  KeepAliveLayout::DeviceNumber::Write(out, fields.device_number);
+  KeepAliveLayout::DeviceType::Write(out, fields.device_type);
+  KeepAliveLayout::DeviceType2::Write(out, fields.device_type);
+  KeepAliveLayout::MacAddress::Write(out, fields.mac_address.data());
+  KeepAliveLayout::IpAddress::Write(out, &fields.ip_address);
+  return kKeepAliveImage.size();
+}
+
+size_t EncodeSyncControl(uint8_t device_number, std::string_view device_name,
+                         SyncCommand command, uint8_t* out, size_t capacity) noexcept {
+  return EncodeControl(kSyncControlImage, device_number, device_name,
+                       static_cast<uint8_t>(command), out, capacity);
+}
+
+size_t EncodeMasterHandoffRequest(uint8_t device_number, std::string_view device_name,
+                                  uint8_t* out, size_t capacity) noexcept {
+  const size_t size = EncodeImage(kHandoffRequestImage, device_name, out, capacity);
+  if (size) {
+    ControlLayout::DeviceNumber::Write(out, device_number);
+    ControlLayout::Sender::Write(out, device_number);
+  }
+  return size;
+}
+
+size_t EncodeMasterHandoffResponse(uint8_t device_number, std::string_view device_name,
+                                   bool accepted, uint8_t* out, size_t capacity) noexcept {
+  return EncodeControl(kHandoffResponseImage, device_number, device_name, accepted ? 0x01 : 0x00,
+                       out, capacity);
+}
+
+size_t EncodePosition(const PositionInfo& info, std::string_view device_name, uint8_t* out,
+                      size_t capacity) noexcept {
+  const size_t size = EncodeImage(kPositionImage, device_name, out, capacity);
+  if (size) {
+    // The wire carries BPM * 10.
+    PositionLayout::DeviceNumber::Write(out, info.device_number);
+    PositionLayout::TrackLength::Write(out, info.track_length_s);
+    PositionLayout::Playhead::Write(out, info.playhead_ms);
+    PositionLayout::Pitch::Write(out, static_cast<uint32_t>(info.pitch));
+    PositionLayout::Bpm::Write(out, info.bpm / 10);
+  }
+  return size;
+}
+
+size_t EncodeMixerStatus(uint8_t device_number, std::string_view device_name, uint32_t bpm,
+                         uint8_t beat_within_bar, bool is_master, uint8_t* out,
+                         size_t capacity) noexcept {
+  const size_t size = EncodeImage(kMixerStatusImage, device_name, out, capacity);
+  if (size) {
+    MixerStatusLayout::DeviceNumber::Write(out, device_number);
+    MixerStatusLayout::Flags::Write(out, MixerStatusLayout::Flags::Read(out) |
+                                             (is_master ? kStatusFlagMaster : 0));
+    MixerStatusLayout::Bpm::Write(out, bpm);
+    MixerStatusLayout::BeatWithinBar::Write(out, beat_within_bar);
+  }
+  return size;
+}
+
+size_t EncodeOnAir(const OnAirInfo& info, std::string_view device_name, uint8_t* out,
+                   size_t capacity) noexcept {
+  const size_t size = EncodeImage(kOnAirImage, device_name, out, capacity);
+  if (size) {
+    uint8_t channels[kMixerChannelCount];
+    for (size_t i = 0; i < kMixerChannelCount; ++i) {
+      channels[i] = info.on_air[i] ? 1 : 0;
+    }
+    MixerChannelLayout::DeviceNumber::Write(out, info.device_number);
+    MixerChannelLayout::Channels::Write(out, channels);
+  }
+  return size;
+}
+
+size_t EncodeFaderStart(const FaderStartInfo& info, std::string_view device_name, uint8_t* out,
+                        size_t capacity) noexcept {
+  const size_t size = EncodeImage(kFaderStartImage, device_name, out, capacity);
+  if (size) {
+    MixerChannelLayout::DeviceNumber::Write(out, info.device_number);
+    MixerChannelLayout::Channels::Write(out, info.commands.data());
+  }
+  return size;
+}
+
+size_t ClassifyDatagrams(const uint8_t* const* data, const size_t* lengths, size_t count,
+                         ClassifiedDatagram* out, uint16_t port) {
+  // Classify in stack-sized chunks so large batches need no allocation.
+  constexpr size_t kChunk = 256;
+  DatagramClass classes[kChunk];
+  size_t accepted = 0;
+  for (size_t start = 0; start < count; start += kChunk) {
+    const size_t n = std::min(kChunk, count - start);
+    ClassifyBatch(data + start, lengths + start, n, port, classes);
+    accepted += CompactAccepted(classes, n, start, out + accepted);
+  }
+  return accepted;
+}
+
+ClassifierIsa ActiveClassifierIsa() {
+  static const ClassifierIsa isa = DetectClassifierIsa();
+  return isa;
+}
+
+namespace {
+
+// Fill one TempoColumns row; zeroes it when the row is not a beat or status.
+void StoreTempoRow(const uint8_t* data, const DatagramClass& cls, uint64_t timestamp_us,
+                   const TempoColumns& out, size_t row, bool* parsed) {
+  const bool accepted = cls.verdict == DatagramVerdict::kAccepted;
+  const bool beat = accepted && cls.type == static_cast<uint8_t>(PacketType::kBeat);
+  const bool status = accepted && cls.type == static_cast<uint8_t>(PacketType::kCdjStatus);
+  *parsed = beat || status;
+  uint8_t device_number = 0;
+  uint16_t bpm = 0;
+  uint32_t pitch = 0;
+  uint32_t beat_number = 0;
+  uint8_t beat_within_bar = 0;
+  uint8_t flags = 0;
+  if (beat) {
+    device_number = BeatLayout::DeviceNumber::Read(data);
+    bpm = BeatLayout::Bpm::Read(data);
+    pitch = BeatLayout::Pitch::Read(data);
+    beat_number = kNoBeatNumber;
+    beat_within_bar = BeatLayout::BeatWithinBar::Read(data);
+  } else if (status) {
+    device_number = StatusLayout::DeviceNumber::Read(data);
+    bpm = StatusLayout::Bpm::Read(data);
+    pitch = StatusLayout::Pitch::Read(data);
+    beat_number = StatusLayout::BeatNumber::Read(data);
+    beat_within_bar = StatusLayout::BeatWithinBar::Read(data);
+    flags = StatusLayout::Flags::Read(data);
+  }
+  if (*parsed && (beat_within_bar < 1 || beat_within_bar > 8)) {
+    beat_within_bar = 1;
+  }
+  if (out.type) {
+    out.type[row] = *parsed ? cls.type : 0;
+  }
+  if (out.device_number) {
+    out.device_number[row] = device_number;
+  }
+  if (out.bpm) {
+    out.bpm[row] = bpm;
+  }
+  if (out.pitch) {
+    out.pitch[row] = pitch;
+  }
+  if (out.beat) {
+    out.beat[row] = beat_number;
+  }
+  if (out.beat_within_bar) {
+    out.beat_within_bar[row] = beat_within_bar;
+  }
+  if (out.flags) {
+    out.flags[row] = flags;
+  }
+  if (out.timestamp_us) {
+    out.timestamp_us[row] = *parsed ? timestamp_us : 0;
+  }
+}
+
+}  // namespace
+
+size_t ParseTempoBatch(const PacketSpan* packets, size_t count, const TempoColumns& out) {
+  // Chunks are a multiple of 64 so each failure word is written whole.
+  constexpr size_t kChunk = 256;
+  const uint8_t* data[kChunk];
+  size_t lengths[kChunk];
+  DatagramClass classes[kChunk];
+  size_t parsed_rows = 0;
+  for (size_t start = 0; start < count; start += kChunk) {
+    const size_t n = std::min(kChunk, count - start);
+    for (size_t i = 0; i < n; ++i) {
+      data[i] = packets[start + i].data;
+      lengths[i] = packets[start + i].data ? packets[start + i].size : 0;
+    }
+    ClassifyBatch(data, lengths, n, kAnyPort, classes);
+    for (size_t word_start = 0; word_start < n; word_start += 64) {
+      uint64_t failures = 0;
+      const size_t word_end = std::min(n, word_start + 64);
+      for (size_t i = word_start; i < word_end; ++i) {
+        bool parsed = false;
+        StoreTempoRow(data[i], classes[i], packets[start + i].timestamp_us, out, start + i,
+                      &parsed);
+        if (parsed) {
+          ++parsed_rows;
+        } else {
+          failures |= uint64_t{1} << (i - word_start);
+        }
+      }
+      if (out.failures) {
+        out.failures[(start + word_start) / 64] = failures;
+      }
+    }
+  }
+  return parsed_rows;
+}
+
+}  // namespace prolink
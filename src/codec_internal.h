@@ -0,0 +1,504 @@
+// Wire layouts and receive-path helpers shared by prolink_codec and
+// prolink_cpp. Not installed; include "prolink/codec.h" for the public API.
+#pragma once
+
+#include "prolink/codec.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+
+namespace prolink {
+namespace internal {
+
+constexpr uint8_t kProlinkHeader[10] = {
+    0x51, 0x73, 0x70, 0x74, 0x31, 0x57, 0x6d, 0x4a, 0x4f, 0x4c,
+};
+
+constexpr size_t kHeaderSize = sizeof(kProlinkHeader);
+constexpr size_t kPacketTypeOffset = 0x0a;
+constexpr size_t kDeviceNameOffset = 0x0b;
+constexpr size_t kPayloadOffset = 0x1f;
+
+constexpr size_t kOffsetDeviceNumber = 0x21;
+
+// Packet layouts. Each field is declared once with its absolute packet
+// offset, width and byte order; the views, the builders and the packet
+// images further down all read and write through these tables.
+
+// Big-endian unsigned integer field of 1-4 bytes.
+template <size_t Offset, size_t Width>
+struct BeField {
+  static_assert(Width >= 1 && Width <= 4, "integer fields are 1-4 bytes wide");
+  static constexpr size_t kOffset = Offset;
+  static constexpr size_t kEnd = Offset + Width;
+  using Value = std::conditional_t<Width == 1, uint8_t,
+                                   std::conditional_t<Width == 2, uint16_t, uint32_t>>;
+
+  static constexpr Value Read(const uint8_t* packet) {
+    uint32_t value = 0;
+    for (size_t i = 0; i < Width; ++i) {
+      value = (value << 8) | packet[Offset + i];
+    }
+    return static_cast<Value>(value);
+  }
+
+  static constexpr void Write(uint8_t* packet, uint32_t value) {
+    for (size_t i = 0; i < Width; ++i) {
+      packet[Offset + Width - 1 - i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+  }
+};
+
+// Byte string copied as-is: device names, and MAC and IPv4 addresses, which
+// stay in network byte order.
+template <size_t Offset, size_t Width>
+struct RawField {
+  static constexpr size_t kOffset = Offset;
+  static constexpr size_t kWidth = Width;
+  static constexpr size_t kEnd = Offset + Width;
+
+  static void Read(const uint8_t* packet, void* out) {
+    std::memcpy(out, packet + Offset, Width);
+  }
+
+  // Writes at most Width bytes; the rest keeps the image's padding.
+  static void Write(uint8_t* packet, const void* in, size_t length = Width) {
+    std::memcpy(packet + Offset, in, std::min(length, Width));
+  }
+};
+
+template <size_t Size, typename... Fields>
+constexpr bool FieldsFit() {
+  return ((Fields::kEnd <= Size) && ...);
+}
+
+using DeviceNameField = RawField<kDeviceNameOffset, kDeviceNameLength>;
+
+// Beat packet (port 50001).
+struct BeatLayout {
+  static constexpr size_t kSize = 0x60;
+  using DeviceNumber = BeField<kOffsetDeviceNumber, 1>;
+  using NextBeat = BeField<0x24, 4>;
+  using SecondBeat = BeField<0x28, 4>;
+  using NextBar = BeField<0x2c, 4>;
+  using FourthBeat = BeField<0x30, 4>;
+  using SecondBar = BeField<0x34, 4>;
+  using EighthBeat = BeField<0x38, 4>;
+  using Pitch = BeField<0x55, 3>;
+  using Bpm = BeField<0x5a, 2>;
+  using BeatWithinBar = BeField<0x5c, 1>;
+  using DeviceNumber2 = BeField<0x5f, 1>;
+};
+static_assert(FieldsFit<BeatLayout::kSize, BeatLayout::DeviceNumber, BeatLayout::NextBeat,
+                        BeatLayout::SecondBeat, BeatLayout::NextBar, BeatLayout::FourthBeat,
+                        BeatLayout::SecondBar, BeatLayout::EighthBeat, BeatLayout::Pitch,
+                        BeatLayout::Bpm, BeatLayout::BeatWithinBar,
+                        BeatLayout::DeviceNumber2>(),
+              "beat field outside the packet");
+
+// CDJ status packet (port 50002). Every generation sends at least
+// kMinimumSize bytes; fields past it need a length check before reading.
+struct StatusLayout {
+  static constexpr size_t kMinimumSize = 0xc8;
+  using DeviceNumber = BeField<kOffsetDeviceNumber, 1>;
+  using DeviceNumber2 = BeField<0x24, 1>;
+  using PlayingFlag = BeField<0x27, 1>;
+  using TrackSourcePlayer = BeField<0x28, 1>;
+  using TrackSourceSlot = BeField<0x29, 1>;
+  using TrackType = BeField<0x2a, 1>;
+  using RekordboxId = BeField<0x2c, 4>;
+  using TrackNumber = BeField<0x32, 2>;
+  using PlayState = BeField<0x7b, 1>;
+  using FirmwareVersion = RawField<0x7c, 4>;
+  using SyncCounter = BeField<0x84, 4>;
+  using Flags = BeField<0x89, 1>;
+  using PlayState2 = BeField<0x8b, 1>;
+  using Pitch = BeField<0x8d, 3>;
+  using Bpm = BeField<0x92, 2>;
+  using PlayState3 = BeField<0x9d, 1>;
+  using MasterFlag = BeField<0x9e, 1>;
+  using MasterHandoff = BeField<0x9f, 1>;
+  using BeatNumber = BeField<0xa0, 4>;
+  using BeatsUntilCue = BeField<0xa4, 2>;
+  using BeatWithinBar = BeField<0xa6, 1>;
+  using PacketCounter = BeField<0xc8, 4>;
+};
+static_assert(FieldsFit<StatusLayout::kMinimumSize, StatusLayout::TrackSourcePlayer,
+                        StatusLayout::TrackSourceSlot, StatusLayout::TrackType,
+                        StatusLayout::RekordboxId, StatusLayout::TrackNumber,
+                        StatusLayout::PlayState, StatusLayout::FirmwareVersion,
+                        StatusLayout::SyncCounter, StatusLayout::Flags, StatusLayout::PlayState2,
+                        StatusLayout::Pitch, StatusLayout::Bpm, StatusLayout::PlayState3,
+                        StatusLayout::MasterHandoff, StatusLayout::BeatNumber,
+                        StatusLayout::BeatsUntilCue, StatusLayout::BeatWithinBar>(),
+              "parsed status field past the minimum status length");
+
+// Device keep-alive (port 50000). The name starts one byte later than in
+// the other packet types.
+struct KeepAliveLayout {
+  static constexpr size_t kSize = 0x36;
+  using DeviceName = RawField<0x0c, kDeviceNameLength>;
+  using Length = BeField<0x22, 2>;
+  using DeviceNumber = BeField<0x24, 1>;
+  using DeviceType = BeField<0x25, 1>;
+  using MacAddress = RawField<0x26, 6>;
+  using IpAddress = RawField<0x2c, 4>;
+  using DeviceType2 = BeField<0x34, 1>;
+};
+static_assert(FieldsFit<KeepAliveLayout::kSize, KeepAliveLayout::DeviceName,
+                        KeepAliveLayout::Length, KeepAliveLayout::DeviceNumber,
+                        KeepAliveLayout::DeviceType, KeepAliveLayout::MacAddress,
+                        KeepAliveLayout::IpAddress, KeepAliveLayout::DeviceType2>(),
+              "keep-alive field outside the packet");
+
+// Sync control and master handoff packets (port 50001). The handoff request
+// ends before the command byte.
+struct ControlLayout {
+  static constexpr size_t kSize = 0x2c;
+  static constexpr size_t kRequestSize = 0x28;
+  using DeviceNumber = BeField<kOffsetDeviceNumber, 1>;
+  using Sender = BeField<0x27, 1>;
+  using Command = BeField<0x2b, 1>;
+};
+static_assert(FieldsFit<ControlLayout::kSize, ControlLayout::DeviceNumber,
+                        ControlLayout::Sender, ControlLayout::Command>(),
+              "control field outside the packet");
+static_assert(FieldsFit<ControlLayout::kRequestSize, ControlLayout::DeviceNumber,
+                        ControlLayout::Sender>(),
+              "handoff request field outside the packet");
+
+// CDJ-3000 precise position (port 50001). Pitch is a signed percentage
+// times 100 and the tempo is pitch-adjusted BPM times 10.
+struct PositionLayout {
+  static constexpr size_t kSize = 0x3c;
+  using DeviceNumber = BeField<kOffsetDeviceNumber, 1>;
+  using TrackLength = BeField<0x24, 4>;
+  using Playhead = BeField<0x28, 4>;
+  using Pitch = BeField<0x2c, 4>;
+  using Bpm = BeField<0x38, 4>;
+};
+static_assert(FieldsFit<PositionLayout::kSize, PositionLayout::DeviceNumber,
+                        PositionLayout::TrackLength, PositionLayout::Playhead,
+                        PositionLayout::Pitch, PositionLayout::Bpm>(),
+              "position field outside the packet");
+
+// Mixer status (port 50002).
+struct MixerStatusLayout {
+  static constexpr size_t kSize = 0x38;
+  using DeviceNumber = BeField<kOffsetDeviceNumber, 1>;
+  using Flags = BeField<0x27, 1>;
+  using Pitch = BeField<0x28, 4>;
+  using Bpm = BeField<0x2e, 2>;
+  using MasterHandoff = BeField<0x36, 1>;
+  using BeatWithinBar = BeField<0x37, 1>;
+};
+static_assert(FieldsFit<MixerStatusLayout::kSize, MixerStatusLayout::DeviceNumber,
+                        MixerStatusLayout::Flags, MixerStatusLayout::Pitch,
+                        MixerStatusLayout::Bpm, MixerStatusLayout::MasterHandoff,
+                        MixerStatusLayout::BeatWithinBar>(),
+              "mixer status field outside the packet");
+
+// Channels on air and fader start (port 50001): one byte per mixer channel.
+struct MixerChannelLayout {
+  static constexpr size_t kOnAirSize = 0x2d;
+  static constexpr size_t kFaderStartSize = 0x28;
+  using DeviceNumber = BeField<kOffsetDeviceNumber, 1>;
+  using Channels = RawField<0x24, kMixerChannelCount>;
+};
+static_assert(FieldsFit<MixerChannelLayout::kFaderStartSize, MixerChannelLayout::DeviceNumber,
+                        MixerChannelLayout::Channels>(),
+              "mixer channel field outside the packet");
+
+constexpr uint8_t kStatusFlagMaster = 0x20;
+constexpr uint8_t kStatusFlagSynced = 0x10;
+constexpr uint8_t kStatusFlagPlaying = 0x40;
+constexpr uint8_t kStatusFlagOnAir = 0x08;
+constexpr uint8_t kStatusFlagBpmSync = 0x02;
+
+constexpr uint16_t kMaxUint16 = 0xffff;
+constexpr uint32_t kMaxUint32 = 0xffffffff;
+
+// Minimum length per packet type on each listening port. Drives both the
+// receive-path classifier and the kernel socket filter.
+struct PacketLengthRule {
+  uint16_t port;
+  PacketType type;
+  size_t min_length;
+};
+
+inline constexpr PacketLengthRule kPacketLengthRules[] = {
+    {kAnnouncePort, PacketType::kDeviceKeepAlive, KeepAliveLayout::kSize},
+    {kBeatPort, PacketType::kBeat, BeatLayout::kSize},
+    {kBeatPort, PacketType::kFaderStart, MixerChannelLayout::kFaderStartSize},
+    {kBeatPort, PacketType::kChannelsOnAir, MixerChannelLayout::kOnAirSize},
+    {kBeatPort, PacketType::kSyncControl, ControlLayout::Command::kEnd},
+    {kBeatPort, PacketType::kMasterHandoffRequest, ControlLayout::DeviceNumber::kEnd},
+    {kBeatPort, PacketType::kMasterHandoffResponse, ControlLayout::Command::kEnd},
+    {kBeatPort, PacketType::kPrecisePosition, PositionLayout::kSize},
+    {kStatusPort, PacketType::kCdjStatus, StatusLayout::kMinimumSize},
+    {kStatusPort, PacketType::kMixerStatus, MixerStatusLayout::kSize},
+};
+
+// Read big-endian integers from packet bytes.
+inline uint16_t ReadBe16(const uint8_t* data, size_t offset) {
+  return static_cast<uint16_t>((data[offset] << 8) | data[offset + 1]);
+}
+
+inline uint32_t ReadBe32(const uint8_t* data, size_t offset) {
+  return (static_cast<uint32_t>(data[offset]) << 24) |
+         (static_cast<uint32_t>(data[offset + 1]) << 16) |
+         (static_cast<uint32_t>(data[offset + 2]) << 8) |
+         static_cast<uint32_t>(data[offset + 3]);
+}
+
+inline uint32_t SafeMul(uint32_t a, uint32_t b) {
+  const uint64_t result = static_cast<uint64_t>(a) * b;
+  return result > kMaxUint32 ? kMaxUint32 : static_cast<uint32_t>(result);
+}
+
+// Compare the 10-byte magic as one 8-byte and one 2-byte load.
+inline bool MagicMatches(const uint8_t* data) {
+  uint64_t head = 0;
+  uint64_t expected_head = 0;
+  uint16_t tail = 0;
+  uint16_t expected_tail = 0;
+  std::memcpy(&head, data, sizeof(head));
+  std::memcpy(&expected_head, kProlinkHeader, sizeof(expected_head));
+  std::memcpy(&tail, data + sizeof(head), sizeof(tail));
+  std::memcpy(&expected_tail, kProlinkHeader + sizeof(head), sizeof(expected_tail));
+  return head == expected_head && tail == expected_tail;
+}
+
+// Validate the 10-byte magic header used by Pro DJ Link UDP packets.
+inline bool HasHeader(const uint8_t* data, size_t length) {
+  return length >= kHeaderSize && MagicMatches(data);
+}
+
+// Receive-path pre-pass verdict for one datagram.
+enum class DatagramVerdict : uint8_t {
+  // Magic matches and the minimum length for the type is met.
+  kAccepted,
+  // Magic matches but the datagram is too short for its type.
+  kShort,
+  // Magic matches but the type is only decoded on other ports, e.g. a
+  // port-50000 claim packet reusing the fader start type byte.
+  kWrongPort,
+  // Too short to carry a type byte, or not Pro DJ Link.
+  kNotProlink,
+};
+
+struct DatagramClass {
+  DatagramVerdict verdict = DatagramVerdict::kNotProlink;
+  uint8_t type = 0;
+};
+
+using MinLengthTable = std::array<uint16_t, 256>;
+
+// Length table entry for a type decoded only on other ports.
+constexpr uint16_t kWrongPortLength = 0xffff;
+
+// Minimum datagram length per type byte on `port` from kPacketLengthRules.
+// Types the library does not decode only need the type byte itself; types
+// with rules on other ports only map to kWrongPortLength. kAnyPort applies
+// every rule regardless of its port.
+constexpr MinLengthTable MinLengthByType(uint16_t port) {
+  MinLengthTable lengths{};
+  for (size_t type = 0; type < lengths.size(); ++type) {
+    lengths[type] = kPacketTypeOffset + 1;
+  }
+  for (const PacketLengthRule& rule : kPacketLengthRules) {
+    lengths[static_cast<uint8_t>(rule.type)] = kWrongPortLength;
+  }
+  for (const PacketLengthRule& rule : kPacketLengthRules) {
+    if (port == kAnyPort || rule.port == port) {
+      lengths[static_cast<uint8_t>(rule.type)] = static_cast<uint16_t>(rule.min_length);
+    }
+  }
+  return lengths;
+}
+
+inline constexpr MinLengthTable kMinLengthAnyPort = MinLengthByType(kAnyPort);
+inline constexpr MinLengthTable kMinLengthAnnouncePort = MinLengthByType(kAnnouncePort);
+inline constexpr MinLengthTable kMinLengthBeatPort = MinLengthByType(kBeatPort);
+inline constexpr MinLengthTable kMinLengthStatusPort = MinLengthByType(kStatusPort);
+
+// Length table for datagrams received on `port`. Ports other than the three
+// Pro DJ Link ports are classified by type alone.
+inline const MinLengthTable& MinLengthsForPort(uint16_t port) {
+  switch (port) {
+    case kAnnouncePort:
+      return kMinLengthAnnouncePort;
+    case kBeatPort:
+      return kMinLengthBeatPort;
+    case kStatusPort:
+      return kMinLengthStatusPort;
+    default:
+      return kMinLengthAnyPort;
+  }
+}
+
+inline DatagramClass FinishClass(bool magic_matches, const uint8_t* data, size_t length,
+                                 const MinLengthTable& min_lengths) {
+  if (!magic_matches) {
+    return {};
+  }
+  const uint8_t type = data[kPacketTypeOffset];
+  const uint16_t min_length = min_lengths[type];
+  if (min_length == kWrongPortLength) {
+    return {DatagramVerdict::kWrongPort, type};
+  }
+  return {length >= min_length ? DatagramVerdict::kAccepted : DatagramVerdict::kShort, type};
+}
+
+inline DatagramClass ClassifyDatagram(const uint8_t* data, size_t length,
+                                      const MinLengthTable& min_lengths) {
+  if (length <= kPacketTypeOffset) {
+    return {};
+  }
+  return FinishClass(MagicMatches(data), data, length, min_lengths);
+}
+
+// Classify a datagram received on `port` (kAnyPort when unknown).
+inline DatagramClass ClassifyDatagram(const uint8_t* data, size_t length, uint16_t port) {
+  return ClassifyDatagram(data, length, MinLengthsForPort(port));
+}
+
+using ClassifyBatchFn = void (*)(const uint8_t* const* data, const size_t* lengths,
+                                 size_t count, uint16_t port, DatagramClass* out);
+
+// Packet image: magic header and type byte, a zeroed device name, and
+// `body` from Offset on. Builders copy an image and patch their fields.
+template <size_t Offset, size_t N>
+constexpr std::array<uint8_t, Offset + N> PacketImage(PacketType type,
+                                                     const uint8_t (&body)[N]) {
+  std::array<uint8_t, Offset + N> image{};
+  for (size_t i = 0; i < kHeaderSize; ++i) {
+    image[i] = kProlinkHeader[i];
+  }
+  image[kPacketTypeOffset] = static_cast<uint8_t>(type);
+  for (size_t i = 0; i < N; ++i) {
+    image[Offset + i] = body[i];
+  }
+  return image;
+}
+
+// Beat image based on observed packets (see Analysis.tex beat packet layout).
+constexpr auto kBeatImage = PacketImage<kPayloadOffset>(
+    PacketType::kBeat,
+    {0x01, 0x00, 0x0d, 0x00, 0x3c, 0x01, 0x01, 0x01, 0x01, 0x02, 0x02, 0x02,
+     0x02, 0x10, 0x10, 0x10, 0x10, 0x04, 0x04, 0x04, 0x04, 0x20, 0x20, 0x20,
+     0x20, 0x08, 0x08, 0x08, 0x08, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+     0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+     0xff, 0xff, 0xff, 0xff, 0x00, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+     0x0b, 0x00, 0x00, 0x0d, 0x00});
+static_assert(kBeatImage.size() == BeatLayout::kSize, "beat image size");
+
+// Status image based on observed CDJ status packets (see Analysis.tex).
+constexpr auto kStatusImage = PacketImage<kPayloadOffset>(
+    PacketType::kCdjStatus,
+    {0x01, 0x04, 0x00, 0x00, 0xf8, 0x00, 0x00, 0x01, 0x00, 0x00, 0x03, 0x01,
+     0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00,
+     0x00, 0x00, 0x00, 0xa0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+     0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x04, 0x04, 0x00, 0x00, 0x00, 0x04,
+     0x00, 0x00, 0x00, 0x04, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+     0x31, 0x2e, 0x34, 0x33, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+     0x00, 0x00, 0xff, 0x00, 0x00, 0x10, 0x00, 0x00, 0x80, 0x00, 0x00, 0x00,
+     0x7f, 0xff, 0xff, 0xff, 0x00, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+     0x00, 0x00, 0x00, 0x00, 0x01, 0xff, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00,
+     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00,
+     0x00, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0f, 0x01, 0x00, 0x00,
+     0x12, 0x34, 0x56, 0x78, 0x00, 0x00, 0x00, 0x01, 0x01, 0x01, 0x01, 0x01,
+     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+     0x00, 0x00, 0x00, 0x15, 0x00, 0x00, 0x07, 0x61, 0x00, 0x00, 0x06, 0x2f});
+static_assert(FieldsFit<kStatusImage.size(), StatusLayout::DeviceNumber,
+                        StatusLayout::DeviceNumber2, StatusLayout::PlayingFlag,
+                        StatusLayout::TrackSourcePlayer, StatusLayout::PlayState,
+                        StatusLayout::Flags, StatusLayout::PlayState2, StatusLayout::Pitch,
+                        StatusLayout::Bpm, StatusLayout::PlayState3,
+                        StatusLayout::MasterFlag, StatusLayout::MasterHandoff,
+                        StatusLayout::BeatNumber, StatusLayout::BeatWithinBar,
+                        StatusLayout::PacketCounter>(),
+              "status field outside the status image");
+
+constexpr auto kSyncControlImage = PacketImage<kPayloadOffset>(
+    PacketType::kSyncControl,
+    {0x01, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00});
+constexpr auto kHandoffRequestImage = PacketImage<kPayloadOffset>(
+    PacketType::kMasterHandoffRequest,
+    {0x01, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x00});
+constexpr auto kHandoffResponseImage = PacketImage<kPayloadOffset>(
+    PacketType::kMasterHandoffResponse,
+    {0x01, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00});
+static_assert(kSyncControlImage.size() == ControlLayout::kSize &&
+                  kHandoffResponseImage.size() == ControlLayout::kSize &&
+                  kHandoffRequestImage.size() == ControlLayout::kRequestSize,
+              "control image size");
+
+constexpr auto kPositionImage = PacketImage<kPayloadOffset>(
+    PacketType::kPrecisePosition,
+    {0x02, 0x00, 0x00, 0x00, 0x18, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+     0x00, 0x00, 0x00, 0x00, 0x00});
+static_assert(kPositionImage.size() == PositionLayout::kSize, "position image size");
+
+constexpr auto kMixerStatusImage = PacketImage<kPayloadOffset>(
+    PacketType::kMixerStatus,
+    {0x01, 0x00, 0x00, 0x00, 0x14, 0x00, 0x00, 0x00, 0xd0, 0x00, 0x10, 0x00,
+     0x00, 0x80, 0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x00, 0x09, 0xff,
+     0x00});
+static_assert(kMixerStatusImage.size() == MixerStatusLayout::kSize, "mixer status image size");
+
+constexpr auto kOnAirImage = PacketImage<kPayloadOffset>(
+    PacketType::kChannelsOnAir,
+    {0x01, 0x00, 0x00, 0x00, 0x09, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+     0x00, 0x00});
+constexpr auto kFaderStartImage = PacketImage<kPayloadOffset>(
+    PacketType::kFaderStart, {0x01, 0x00, 0x00, 0x00, 0x04, 0x02, 0x02, 0x02, 0x02});
+static_assert(kOnAirImage.size() == MixerChannelLayout::kOnAirSize &&
+                  kFaderStartImage.size() == MixerChannelLayout::kFaderStartSize,
+              "mixer channel image size");
+
+constexpr auto kKeepAliveImage = PacketImage<KeepAliveLayout::DeviceName::kEnd>(
+    PacketType::kDeviceKeepAlive,
+    {0x01, 0x02, 0x00, 0x36, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+     0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00});
+static_assert(kKeepAliveImage.size() == KeepAliveLayout::kSize, "keep-alive image size");
+static_assert(KeepAliveLayout::Length::Read(kKeepAliveImage.data()) == KeepAliveLayout::kSize,
+              "keep-alive length field");
+
+// Batch classifier picked once from the instruction sets the CPU supports.
+// Every datagram in the batch was received on `port`.
+void ClassifyBatch(const uint8_t* const* data, const size_t* lengths, size_t count,
+                   uint16_t port, DatagramClass* out);
+
+// Batch classifier for `isa`, or nullptr if this build or CPU lacks it.
+ClassifyBatchFn ClassifierFor(ClassifierIsa isa);
+
+// Keep the accepted datagrams as (index, type) entries in input order,
+// numbering them from `first_index`.
+size_t CompactAccepted(const DatagramClass* classes, size_t count, size_t first_index,
+                       ClassifiedDatagram* out);
+
+// Trimmed view of the 20-byte device name field at a specific offset.
+std::string_view DeviceNameViewAt(const uint8_t* data, size_t length, size_t offset);
+
+// Convert pitch value to a multiplier (1.0 at neutral pitch).
+double PitchToMultiplier(uint32_t pitch);
+
+}  // namespace internal
+}  // namespace prolink
@@ -1,6 +1,8 @@
 #include "prolink/prolink.h"
 #include "prolink/test_hooks.h"
 
+#include "codec_internal.h"
+
 #include <algorithm>
 #include <array>
 #include <cassert>
@@ -10,312 +12,1483 @@
 #include <cstring>
 #include <cerrno>
 #include <fstream>
+#include <functional>
 #include <iostream>
 #include <mutex>
 #include <sstream>
 #include <thread>
+#include <type_traits>
 #include <unordered_map>
 
 #include <arpa/inet.h>
+#include <fcntl.h>
 #include <netinet/in.h>
+#include <ifaddrs.h>
+#include <net/if.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/ioctl.h>
 #include <sys/select.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
+#ifdef __linux__
+#include <linux/filter.h>
+#include <linux/if_packet.h>
+#include <linux/sock_diag.h>
+#include <net/ethernet.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#elif defined(__APPLE__) || defined(__FreeBSD__)
+#include <net/if_dl.h>
+#endif
+
+#ifdef PROLINK_HAVE_IO_URING
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#endif
+
 namespace prolink {
-namespace {
 
-constexpr uint8_t kProlinkHeader[10] = {
-    0x51, 0x73, 0x70, 0x74, 0x31, 0x57, 0x6d, 0x4a, 0x4f, 0x4c,
-};
+using namespace internal;
 
-constexpr size_t kHeaderSize = sizeof(kProlinkHeader);
-constexpr size_t kPacketTypeOffset = 0x0a;
-constexpr size_t kDeviceNameOffset = 0x0b;
-constexpr size_t kPayloadOffset = 0x1f;
-
-constexpr size_t kOffsetDeviceNumber = 0x21;
-
-constexpr size_t kOffsetBeatNext = 0x24;
-constexpr size_t kOffsetBeatNextBar = 0x2c;
-constexpr size_t kOffsetBeatPitch = 0x55;
-constexpr size_t kOffsetBeatBpm = 0x5a;
-constexpr size_t kOffsetBeatWithinBar = 0x5c;
-
-constexpr size_t kOffsetStatusPitch = 0x8d;
-constexpr size_t kOffsetStatusBpm = 0x92;
-constexpr size_t kOffsetStatusFlags = 0x89;
-constexpr size_t kOffsetStatusBeat = 0xa0;
-constexpr size_t kOffsetStatusBeatWithinBar = 0xa6;
-constexpr size_t kOffsetStatusMasterHandoff = 0x9f;
-
-constexpr size_t kOffsetKeepAliveDeviceNumber = 0x24;
-constexpr size_t kOffsetKeepAliveDeviceType = 0x25;
-constexpr size_t kOffsetKeepAliveMac = 0x26;
-constexpr size_t kOffsetKeepAliveIp = 0x2c;
-
-// Payload offsets (relative to payload start at 0x1f).
-constexpr size_t kControlPayloadSize = 0x0d;
-constexpr size_t kControlPayloadDeviceNumber = 0x02;
-constexpr size_t kControlPayloadSender = 0x08;
-constexpr size_t kControlPayloadCommand = 0x0c;
-
-constexpr size_t kHandoffRequestPayloadSize = 0x09;
-
-constexpr size_t kOffsetMasterHandoffAccepted = kPayloadOffset + kControlPayloadCommand;
-
-constexpr size_t kOffsetBeatPayloadDeviceNumber = 0x02;
-constexpr size_t kOffsetBeatPayloadInterval = 0x05;
-constexpr size_t kOffsetBeatPayloadInterval2 = 0x09;
-constexpr size_t kOffsetBeatPayloadNextBar = 0x0d;
-constexpr size_t kOffsetBeatPayloadInterval4 = 0x11;
-constexpr size_t kOffsetBeatPayloadNextBar2 = 0x15;
-constexpr size_t kOffsetBeatPayloadInterval8 = 0x19;
-constexpr size_t kOffsetBeatPayloadPitch = 0x36;
-constexpr size_t kOffsetBeatPayloadBpm = 0x3b;
-constexpr size_t kOffsetBeatPayloadBeatWithinBar = 0x3d;
-constexpr size_t kOffsetBeatPayloadDeviceNumber2 = 0x40;
-
-constexpr size_t kOffsetStatusPayloadDeviceNumber = 0x02;
-constexpr size_t kOffsetStatusPayloadDeviceNumber2 = 0x05;
-constexpr size_t kOffsetStatusPayloadPlayingFlag = 0x08;
-constexpr size_t kOffsetStatusPayloadDeviceNumber3 = 0x09;
-constexpr size_t kOffsetStatusPayloadPlayState = 0x5c;
-constexpr size_t kOffsetStatusPayloadFlagByte = 0x6a;
-constexpr size_t kOffsetStatusPayloadPlayState2 = 0x6c;
-constexpr size_t kOffsetStatusPayloadPitch = 0x6e;
-constexpr size_t kOffsetStatusPayloadBpm = 0x73;
-constexpr size_t kOffsetStatusPayloadPlayState3 = 0x7e;
-constexpr size_t kOffsetStatusPayloadMasterFlag = 0x7f;
-constexpr size_t kOffsetStatusPayloadMasterHandoff = 0x80;
-constexpr size_t kOffsetStatusPayloadBeatNumber = 0x81;
-constexpr size_t kOffsetStatusPayloadBeatWithinBar = 0x87;
-constexpr size_t kOffsetStatusPayloadPacketCounter = 0xa9;
+namespace {
 
 constexpr size_t kMaxReplayPacketSize = 2048;
+// Capture files start with this magic and a format version. Files without
+// it are read as headerless legacy captures, whose records have no port.
+constexpr char kCaptureMagic[4] = {'P', 'L', 'C', 'P'};
+constexpr uint32_t kCaptureVersion = 1;
+// Largest datagram expected on each listening port; receive slots are sized
+// per port so nothing legitimate is truncated. Status packets grow with each
+// player generation (0xd4 on CDJ-2000, 0x124 on NXS2, 0x200 on CDJ-3000), so
+// port 50002 leaves room for newer firmware.
+constexpr size_t kMaxAnnouncePortPacket = 0x200;
+constexpr size_t kMaxBeatPortPacket = 0x200;
+constexpr size_t kMaxStatusPortPacket = 0x800;
+constexpr int kMaxRecvBatchSize = 1024;
+constexpr int kMaxReactorEvents = 16;
+constexpr size_t kRecvControlSize = 64;
+constexpr size_t kMaxSendPacketSize = 512;
+// Rate limiter bucket table bound and idle eviction age.
+constexpr size_t kMaxRateLimitBuckets = 4096;
+constexpr std::chrono::seconds kRateLimitIdleTimeout{10};
+// Empty polls before BusyPollBackoff::kYield hands the core back.
+constexpr unsigned kBusyPollYieldAfter = 64;
+// Multi-interface sessions: interface limit, and how many recent packets and
+// how far back the cross-interface duplicate filter remembers.
+constexpr size_t kMaxInterfaces = 8;
+constexpr size_t kDuplicateHistory = 64;
+constexpr std::chrono::milliseconds kDuplicateWindow{20};
+// How often Config::auto_network re-reads the host's interface addresses.
+constexpr std::chrono::seconds kNetworkRefreshInterval{2};
+
+constexpr uint32_t kMonitorBlockSize = 1u << 20;
+constexpr uint32_t kMonitorBlockCount = 8;
+constexpr uint32_t kMonitorFrameSize = 2048;
+constexpr uint32_t kMonitorBlockTimeoutMs = 2;
+constexpr size_t kEthernetHeaderSize = 14;
+constexpr size_t kIpv4MinHeaderSize = 20;
+constexpr size_t kUdpHeaderSize = 8;
 
-constexpr uint8_t kStatusFlagMaster = 0x20;
-constexpr uint8_t kStatusFlagSynced = 0x10;
-constexpr uint8_t kStatusFlagPlaying = 0x40;
+// Forward declarations
+void LogError(const std::string& message, const Config* config);
 
-constexpr size_t kBeatPacketSize = 96;
-constexpr size_t kStatusMinimumSize = 0xc8;
+// Interfaces the session opens sockets on, with defaults filled in. An empty
+// Config::interfaces means one interface from the top-level address fields.
+std::vector<InterfaceConfig> ResolveInterfaces(const Config& config) {
+  if (config.interfaces.empty()) {
+    InterfaceConfig iface;
+    iface.bind_address = config.bind_address;
+    iface.broadcast_address = config.broadcast_address;
+    iface.announce_address = config.announce_address;
+    iface.device_ip = config.device_ip;
+    return {iface};
+  }
+  std::vector<InterfaceConfig> interfaces = config.interfaces;
+  for (InterfaceConfig& iface : interfaces) {
+    if (iface.announce_address.empty()) {
+      iface.announce_address = iface.broadcast_address;
+    }
+    if (iface.device_ip.empty()) {
+      iface.device_ip = config.device_ip;
+    }
+  }
+  return interfaces;
+}
 
-constexpr uint16_t kMaxUint16 = 0xffff;
-constexpr uint32_t kMaxUint32 = 0xffffffff;
-constexpr size_t kKeepAlivePacketSize = 0x36;
+// Convert a string address and port into a sockaddr_in.
+sockaddr_in MakeSockaddr(const std::string& address, uint16_t port) {
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(port);
+  if (address.empty() || address == "0.0.0.0") {
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+  } else {
+    if (inet_pton(AF_INET, address.c_str(), &addr.sin_addr) != 1) {
+      addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    }
+  }
+  return addr;
+}
 
-// Forward declarations
-void LogError(const std::string& message, const Config* config);
+// Destination for an IPv4 address already in network byte order.
+sockaddr_in Ipv4Sockaddr(uint32_t address, uint16_t port) {
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(port);
+  addr.sin_addr.s_addr = address;
+  return addr;
+}
+
+std::string Ipv4ToString(uint32_t address) {
+  in_addr addr{};
+  addr.s_addr = address;
+  char buffer[INET_ADDRSTRLEN] = {0};
+  if (inet_ntop(AF_INET, &addr, buffer, sizeof(buffer)) != nullptr) {
+    return buffer;
+  }
+  return {};
+}
+
+// Parse "a.b.c.d/n" into a network address and mask (network byte order).
+bool ParseSubnet(const std::string& text, uint32_t* network, uint32_t* mask) {
+  const size_t slash = text.find('/');
+  if (slash == std::string::npos || slash + 1 >= text.size()) {
+    return false;
+  }
+  in_addr addr{};
+  if (inet_pton(AF_INET, text.substr(0, slash).c_str(), &addr) != 1) {
+    return false;
+  }
+  const std::string bits_text = text.substr(slash + 1);
+  if (bits_text.find_first_not_of("0123456789") != std::string::npos || bits_text.size() > 2) {
+    return false;
+  }
+  const int bits = std::atoi(bits_text.c_str());
+  if (bits > 32) {
+    return false;
+  }
+  const uint32_t host_mask = bits == 0 ? 0 : ~0u << (32 - bits);
+  *mask = htonl(host_mask);
+  *network = addr.s_addr & *mask;
+  return true;
+}
+
+// An IPv4 address of a local network interface, as reported by getifaddrs.
+// Addresses are in network byte order.
+struct HostInterface {
+  std::string name;
+  uint32_t address = 0;
+  uint32_t netmask = 0;
+  uint32_t broadcast = 0;
+  std::array<uint8_t, 6> mac_address = {0, 0, 0, 0, 0, 0};
+  bool up = false;
+  bool loopback = false;
+  bool can_broadcast = false;
 
-// Read big-endian integers from packet bytes.
-uint16_t ReadBe16(const uint8_t* data, size_t offset) {
-  return static_cast<uint16_t>((data[offset] << 8) | data[offset + 1]);
+  bool Contains(uint32_t peer) const {
+    return (peer & netmask) == (address & netmask);
+  }
+};
+
+// Hardware address of an interface, or all zeros if it has none.
+std::array<uint8_t, 6> InterfaceMac(const std::string& name, const ifaddrs* all) {
+  std::array<uint8_t, 6> mac = {0, 0, 0, 0, 0, 0};
+#ifdef __linux__
+  (void)all;
+  const int fd = ::socket(AF_INET, SOCK_DGRAM, 0);
+  if (fd < 0) {
+    return mac;
+  }
+  ifreq request{};
+  std::strncpy(request.ifr_name, name.c_str(), IFNAMSIZ - 1);
+  if (::ioctl(fd, SIOCGIFHWADDR, &request) == 0) {
+    std::memcpy(mac.data(), request.ifr_hwaddr.sa_data, mac.size());
+  }
+  ::close(fd);
+#elif defined(__APPLE__) || defined(__FreeBSD__)
+  for (const ifaddrs* entry = all; entry; entry = entry->ifa_next) {
+    if (entry->ifa_addr && entry->ifa_addr->sa_family == AF_LINK && name == entry->ifa_name) {
+      const auto* link = reinterpret_cast<const sockaddr_dl*>(entry->ifa_addr);
+      if (link->sdl_alen == mac.size()) {
+        std::memcpy(mac.data(), LLADDR(link), mac.size());
+      }
+      break;
+    }
+  }
+#else
+  (void)name;
+  (void)all;
+#endif
+  return mac;
 }
 
-uint32_t ReadBe24(const uint8_t* data, size_t offset) {
-  return (static_cast<uint32_t>(data[offset]) << 16) |
-         (static_cast<uint32_t>(data[offset + 1]) << 8) |
-         static_cast<uint32_t>(data[offset + 2]);
+// IPv4 addresses of the host's interfaces. Interfaces without a broadcast
+// address (loopback, point-to-point) get the directed broadcast of their
+// subnet.
+std::vector<HostInterface> ListHostInterfaces() {
+  std::vector<HostInterface> result;
+  ifaddrs* all = nullptr;
+  if (::getifaddrs(&all) != 0) {
+    return result;
+  }
+  for (const ifaddrs* entry = all; entry; entry = entry->ifa_next) {
+    if (!entry->ifa_addr || entry->ifa_addr->sa_family != AF_INET || !entry->ifa_netmask) {
+      continue;
+    }
+    HostInterface host;
+    host.name = entry->ifa_name;
+    host.address = reinterpret_cast<const sockaddr_in*>(entry->ifa_addr)->sin_addr.s_addr;
+    host.netmask = reinterpret_cast<const sockaddr_in*>(entry->ifa_netmask)->sin_addr.s_addr;
+    host.up = (entry->ifa_flags & IFF_UP) != 0;
+    host.loopback = (entry->ifa_flags & IFF_LOOPBACK) != 0;
+    host.can_broadcast = (entry->ifa_flags & IFF_BROADCAST) != 0;
+    if (host.can_broadcast && entry->ifa_broadaddr) {
+      host.broadcast =
+          reinterpret_cast<const sockaddr_in*>(entry->ifa_broadaddr)->sin_addr.s_addr;
+    } else {
+      host.broadcast = host.address | ~host.netmask;
+    }
+    host.mac_address = InterfaceMac(host.name, all);
+    result.push_back(std::move(host));
+  }
+  ::freeifaddrs(all);
+  return result;
 }
 
-uint32_t ReadBe32(const uint8_t* data, size_t offset) {
-  return (static_cast<uint32_t>(data[offset]) << 24) |
-         (static_cast<uint32_t>(data[offset + 1]) << 16) |
-         (static_cast<uint32_t>(data[offset + 2]) << 8) |
-         static_cast<uint32_t>(data[offset + 3]);
+// Pick the interface for Config::auto_network. A selector is an interface
+// name or a CIDR subnet. Without one, prefer the interface holding the bind
+// address, then one on the same subnet as a known Pro DJ Link device (most
+// recent first), then the first broadcast-capable interface that is up.
+const HostInterface* SelectHostInterface(const std::vector<HostInterface>& hosts,
+                                         const std::string& selector,
+                                         uint32_t bind_address,
+                                         const std::vector<uint32_t>& peers) {
+  uint32_t network = 0;
+  uint32_t mask = 0;
+  if (ParseSubnet(selector, &network, &mask)) {
+    for (const HostInterface& host : hosts) {
+      if (host.up && (host.address & mask) == network) {
+        return &host;
+      }
+    }
+    return nullptr;
+  }
+  if (!selector.empty()) {
+    for (const HostInterface& host : hosts) {
+      if (host.up && host.name == selector) {
+        return &host;
+      }
+    }
+    return nullptr;
+  }
+  for (const HostInterface& host : hosts) {
+    if (bind_address != htonl(INADDR_ANY) && host.address == bind_address) {
+      return &host;
+    }
+  }
+  for (const uint32_t peer : peers) {
+    for (const HostInterface& host : hosts) {
+      if (host.up && !host.loopback && host.Contains(peer)) {
+        return &host;
+      }
+    }
+  }
+  for (const HostInterface& host : hosts) {
+    if (host.up && !host.loopback && host.can_broadcast) {
+      return &host;
+    }
+  }
+  return nullptr;
 }
 
-// Write big-endian integers into packet payloads.
-void WriteBe16(std::vector<uint8_t>& data, size_t offset, uint32_t value) {
-  data[offset] = static_cast<uint8_t>((value >> 8) & 0xff);
-  data[offset + 1] = static_cast<uint8_t>(value & 0xff);
+#ifdef __linux__
+// Map a CLOCK_REALTIME kernel timestamp into the steady clock domain, given
+// one paired reading of both clocks.
+std::chrono::steady_clock::time_point SteadyFromRealtime(
+    const timespec& stamp, std::chrono::steady_clock::time_point steady_now,
+    std::chrono::system_clock::time_point system_now) {
+  const auto kernel_time = std::chrono::system_clock::time_point(
+      std::chrono::duration_cast<std::chrono::system_clock::duration>(
+          std::chrono::seconds(stamp.tv_sec) +
+          std::chrono::nanoseconds(stamp.tv_nsec)));
+  const auto age = system_now - kernel_time;
+  if (age <= std::chrono::system_clock::duration::zero()) {
+    return steady_now;
+  }
+  return steady_now - std::chrono::duration_cast<std::chrono::steady_clock::duration>(age);
 }
 
-void WriteBe24(std::vector<uint8_t>& data, size_t offset, uint32_t value) {
-  data[offset] = static_cast<uint8_t>((value >> 16) & 0xff);
-  data[offset + 1] = static_cast<uint8_t>((value >> 8) & 0xff);
-  data[offset + 2] = static_cast<uint8_t>(value & 0xff);
+// Map the SCM_TIMESTAMPNS control message of a received datagram into the
+// steady clock domain.
+std::chrono::steady_clock::time_point ReceiveTimeFromControl(
+    msghdr* hdr, std::chrono::steady_clock::time_point steady_now,
+    std::chrono::system_clock::time_point system_now) {
+  for (cmsghdr* cmsg = CMSG_FIRSTHDR(hdr); cmsg != nullptr;
+       cmsg = CMSG_NXTHDR(hdr, cmsg)) {
+    if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_TIMESTAMPNS) {
+      timespec stamp{};
+      std::memcpy(&stamp, CMSG_DATA(cmsg), sizeof(stamp));
+      return SteadyFromRealtime(stamp, steady_now, system_now);
+    }
+  }
+  return steady_now;
 }
+#endif
 
-void WriteBe32(std::vector<uint8_t>& data, size_t offset, uint32_t value) {
-  data[offset] = static_cast<uint8_t>((value >> 24) & 0xff);
-  data[offset + 1] = static_cast<uint8_t>((value >> 16) & 0xff);
-  data[offset + 2] = static_cast<uint8_t>((value >> 8) & 0xff);
-  data[offset + 3] = static_cast<uint8_t>(value & 0xff);
+// Receive slot size for a listening port.
+constexpr size_t RecvSlotSize(uint16_t port) {
+  return port == kStatusPort   ? kMaxStatusPortPacket
+         : port == kBeatPort   ? kMaxBeatPortPacket
+                               : kMaxAnnouncePortPacket;
 }
 
-uint32_t SafeMul(uint32_t a, uint32_t b) {
-  const uint64_t result = static_cast<uint64_t>(a) * b;
-  return result > kMaxUint32 ? kMaxUint32 : static_cast<uint32_t>(result);
+// Preallocated multi-slot receive buffers for batched datagram reads.
+class RecvRing {
+ public:
+  RecvRing(size_t slots, size_t slot_size)
+      : slot_size_(slot_size),
+        storage_(slots * slot_size),
+        sources_(slots),
+        slots_(slots),
+        lengths_(slots, 0),
+        classes_(slots),
+        truncated_(slots, 0),
+        receive_times_(slots) {
+    for (size_t i = 0; i < slots; ++i) {
+      slots_[i] = storage_.data() + i * slot_size_;
+    }
+#ifdef __linux__
+    control_.resize(slots);
+    iovecs_.resize(slots);
+    headers_.resize(slots);
+    for (size_t i = 0; i < slots; ++i) {
+      iovecs_[i].iov_base = storage_.data() + i * slot_size_;
+      iovecs_[i].iov_len = slot_size_;
+      headers_[i].msg_hdr.msg_iov = &iovecs_[i];
+      headers_[i].msg_hdr.msg_iovlen = 1;
+    }
+#endif
+  }
+
+  size_t capacity() const { return lengths_.size(); }
+  size_t slot_size() const { return slot_size_; }
+  uint8_t* data(size_t slot) { return storage_.data() + slot * slot_size_; }
+  size_t length(size_t slot) const { return lengths_[slot]; }
+  // Run the batch classifier over the first `count` slots, received on `port`.
+  void Classify(size_t count, uint16_t port) {
+    ClassifyBatch(slots_.data(), lengths_.data(), count, port, classes_.data());
+  }
+  const DatagramClass& datagram_class(size_t slot) const { return classes_[slot]; }
+  // True if the datagram did not fit in the slot (MSG_TRUNC).
+  bool truncated(size_t slot) const { return truncated_[slot] != 0; }
+  const sockaddr_in& source(size_t slot) const { return sources_[slot]; }
+  std::chrono::steady_clock::time_point receive_time(size_t slot) const {
+    return receive_times_[slot];
+  }
+
+ private:
+  friend class UdpSocket;
+
+  // Control message space for SCM_TIMESTAMPNS, aligned for cmsghdr access.
+  struct alignas(cmsghdr) ControlBuffer {
+    uint8_t bytes[kRecvControlSize];
+  };
+
+  size_t slot_size_;
+  std::vector<uint8_t> storage_;
+  std::vector<sockaddr_in> sources_;
+  std::vector<const uint8_t*> slots_;
+  std::vector<size_t> lengths_;
+  std::vector<DatagramClass> classes_;
+  std::vector<uint8_t> truncated_;
+  std::vector<std::chrono::steady_clock::time_point> receive_times_;
+#ifdef __linux__
+  std::vector<ControlBuffer> control_;
+  std::vector<iovec> iovecs_;
+  std::vector<mmsghdr> headers_;
+#endif
+};
+
+// Optional per-socket settings for UdpSocket::Open.
+struct SocketOptions {
+  // Buffer sizes of 0 keep the system defaults.
+  int recv_buffer_bytes = 0;
+  int send_buffer_bytes = 0;
+  // Interface to bind with SO_BINDTODEVICE; empty binds by address only.
+  std::string device;
+  // Session interface index reported with datagrams from this socket.
+  uint8_t interface_index = 0;
+};
+
+// Minimal UDP socket wrapper for send/recv with broadcast support.
+class UdpSocket {
+ public:
+  UdpSocket() = default;
+  ~UdpSocket() { Close(); }
+
+  bool Open(uint16_t port, const std::string& bind_address, bool allow_broadcast,
+            const SocketOptions& options = {}) {
+    if (fd_ >= 0) {
+      return true;
+    }
+    port_ = port;
+    interface_index_ = options.interface_index;
+    fd_ = ::socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd_ < 0) {
+      last_error_ = "socket() failed: " + std::string(std::strerror(errno));
+      return false;
+    }
+    int reuse = 1;
+    if (::setsockopt(fd_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse)) < 0) {
+      last_error_ = "setsockopt(SO_REUSEADDR) failed: " + std::string(std::strerror(errno));
+      Close();
+      return false;
+    }
+    if (allow_broadcast) {
+      int broadcast = 1;
+      if (::setsockopt(fd_, SOL_SOCKET, SO_BROADCAST, &broadcast, sizeof(broadcast)) < 0) {
+        last_error_ = "setsockopt(SO_BROADCAST) failed: " + std::string(std::strerror(errno));
+        Close();
+        return false;
+      }
+    }
+#ifdef SO_TIMESTAMPNS
+    // Best effort: without kernel timestamps receive_time falls back to the
+    // time the batch was read.
+    int timestamps = 1;
+    ::setsockopt(fd_, SOL_SOCKET, SO_TIMESTAMPNS, &timestamps, sizeof(timestamps));
+#endif
+    if (options.recv_buffer_bytes > 0 &&
+        !SetBufferSize(SO_RCVBUF, kRecvBufferForce, options.recv_buffer_bytes, "SO_RCVBUF")) {
+      Close();
+      return false;
+    }
+    if (options.send_buffer_bytes > 0 &&
+        !SetBufferSize(SO_SNDBUF, kSendBufferForce, options.send_buffer_bytes, "SO_SNDBUF")) {
+      Close();
+      return false;
+    }
+#ifdef SO_BINDTODEVICE
+    // Must precede bind() so sockets on different devices can share a port.
+    if (!options.device.empty() &&
+        ::setsockopt(fd_, SOL_SOCKET, SO_BINDTODEVICE, options.device.c_str(),
+                     static_cast<socklen_t>(options.device.size())) < 0) {
+      last_error_ = "setsockopt(SO_BINDTODEVICE, " + options.device +
+                    ") failed: " + std::string(std::strerror(errno));
+      Close();
+      return false;
+    }
+#endif
+    sockaddr_in addr = MakeSockaddr(bind_address, port);
+    if (::bind(fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+      std::ostringstream oss;
+      oss << "bind(" << bind_address << ":" << port << ") failed: "
+          << std::strerror(errno);
+      last_error_ = oss.str();
+      Close();
+      return false;
+    }
+    return true;
+  }
+
+  void Close() {
+    if (fd_ >= 0) {
+      ::close(fd_);
+      fd_ = -1;
+    }
+  }
+
+  int fd() const { return fd_; }
+  // Port passed to Open() (0 for an ephemeral port).
+  uint16_t port() const { return port_; }
+  uint8_t interface_index() const { return interface_index_; }
+  const std::string& last_error() const { return last_error_; }
+
+  // Attach a classic BPF program that keeps only datagrams carrying the
+  // Pro DJ Link magic, a packet type expected on this port, and at least the
+  // minimum length for that type.
+  bool AttachProlinkFilter(uint16_t port) {
+#ifdef __linux__
+    // UDP socket filters see the UDP header at offset 0.
+    constexpr uint32_t kBase = kUdpHeaderSize;
+    std::vector<sock_filter> code;
+    auto emit = [&code](uint16_t op, uint8_t jt, uint8_t jf, uint32_t k) {
+      code.push_back(sock_filter{op, jt, jf, k});
+    };
+    size_t rule_count = 0;
+    for (const auto& rule : kPacketLengthRules) {
+      rule_count += rule.port == port ? 1 : 0;
+    }
+    // Layout: 8 prefix instructions, 4 per rule, then reject and accept.
+    const size_t reject = 8 + 4 * rule_count;
+    const size_t accept = reject + 1;
+    auto to = [&code](size_t target) {
+      return static_cast<uint8_t>(target - code.size() - 1);
+    };
+    emit(BPF_LD | BPF_W | BPF_LEN, 0, 0, 0);
+    emit(BPF_JMP | BPF_JGE | BPF_K, 0, to(reject), kBase + kPacketTypeOffset + 1);
+    emit(BPF_LD | BPF_W | BPF_ABS, 0, 0, kBase);
+    emit(BPF_JMP | BPF_JEQ | BPF_K, 0, to(reject), ReadBe32(kProlinkHeader, 0));
+    emit(BPF_LD | BPF_W | BPF_ABS, 0, 0, kBase + 4);
+    emit(BPF_JMP | BPF_JEQ | BPF_K, 0, to(reject), ReadBe32(kProlinkHeader, 4));
+    emit(BPF_LD | BPF_H | BPF_ABS, 0, 0, kBase + 8);
+    emit(BPF_JMP | BPF_JEQ | BPF_K, 0, to(reject), ReadBe16(kProlinkHeader, 8));
+    for (const auto& rule : kPacketLengthRules) {
+      if (rule.port != port) {
+        continue;
+      }
+      emit(BPF_LD | BPF_B | BPF_ABS, 0, 0, kBase + kPacketTypeOffset);
+      emit(BPF_JMP | BPF_JEQ | BPF_K, 0, 2, static_cast<uint8_t>(rule.type));
+      emit(BPF_LD | BPF_W | BPF_LEN, 0, 0, 0);
+      emit(BPF_JMP | BPF_JGE | BPF_K, to(accept), to(reject),
+           static_cast<uint32_t>(kBase + rule.min_length));
+    }
+    emit(BPF_RET | BPF_K, 0, 0, 0);
+    emit(BPF_RET | BPF_K, 0, 0, 0xffffffff);
+    sock_fprog program{};
+    program.len = static_cast<unsigned short>(code.size());
+    program.filter = code.data();
+    if (::setsockopt(fd_, SOL_SOCKET, SO_ATTACH_FILTER, &program, sizeof(program)) < 0) {
+      last_error_ = "setsockopt(SO_ATTACH_FILTER) failed: " + std::string(std::strerror(errno));
+      return false;
+    }
+#else
+    (void)port;
+#endif
+    return true;
+  }
+
+  // Datagrams the kernel discarded for this socket (filter rejects and
+  // receive queue overflows), or 0 if unavailable.
+  uint64_t KernelDrops() const {
+#if defined(__linux__) && defined(SO_MEMINFO)
+    if (fd_ >= 0) {
+      uint32_t meminfo[SK_MEMINFO_VARS] = {};
+      socklen_t len = sizeof(meminfo);
+      if (::getsockopt(fd_, SOL_SOCKET, SO_MEMINFO, meminfo, &len) == 0) {
+        return meminfo[SK_MEMINFO_DROPS];
+      }
+    }
+#endif
+    return 0;
+  }
+
+  // Ask the kernel to busy-poll the device queue for up to usecs on reads
+  // that find the socket empty. Best effort: returns false if unsupported or
+  // not permitted.
+  bool EnableBusyPoll(int usecs) {
+#ifdef SO_BUSY_POLL
+    if (::setsockopt(fd_, SOL_SOCKET, SO_BUSY_POLL, &usecs, sizeof(usecs)) < 0) {
+      return false;
+    }
+#ifdef SO_PREFER_BUSY_POLL
+    int prefer = 1;
+    ::setsockopt(fd_, SOL_SOCKET, SO_PREFER_BUSY_POLL, &prefer, sizeof(prefer));
+#endif
+    return true;
+#else
+    (void)usecs;
+    return false;
+#endif
+  }
+
+  // Bytes currently held in the receive queue, including per-datagram kernel
+  // overhead on Linux (SIOCINQ only reports the next datagram for UDP).
+  uint64_t QueuedBytes() const {
+    if (fd_ < 0) {
+      return 0;
+    }
+#if defined(__linux__) && defined(SO_MEMINFO)
+    uint32_t meminfo[SK_MEMINFO_VARS] = {};
+    socklen_t len = sizeof(meminfo);
+    if (::getsockopt(fd_, SOL_SOCKET, SO_MEMINFO, meminfo, &len) == 0) {
+      return meminfo[SK_MEMINFO_RMEM_ALLOC];
+    }
+    return 0;
+#else
+    int queued = 0;
+    if (::ioctl(fd_, FIONREAD, &queued) == 0 && queued > 0) {
+      return static_cast<uint64_t>(queued);
+    }
+    return 0;
+#endif
+  }
+
+  // Receive buffer size granted by the kernel.
+  uint64_t RecvBufferBytes() const {
+    int size = 0;
+    socklen_t len = sizeof(size);
+    if (fd_ < 0 || ::getsockopt(fd_, SOL_SOCKET, SO_RCVBUF, &size, &len) < 0 || size < 0) {
+      return 0;
+    }
+    return static_cast<uint64_t>(size);
+  }
+
+  ssize_t SendTo(const uint8_t* data, size_t size, const sockaddr_in& addr) {
+    return ::sendto(fd_, data, size, 0, reinterpret_cast<const sockaddr*>(&addr),
+                    sizeof(addr));
+  }
+
+  // Read up to ring->capacity() queued datagrams without blocking.
+  // Returns the number of slots filled, or -1 with errno set.
+  int RecvBatch(RecvRing* ring) {
+#ifdef __linux__
+    for (size_t i = 0; i < ring->capacity(); ++i) {
+      msghdr& hdr = ring->headers_[i].msg_hdr;
+      hdr.msg_name = &ring->sources_[i];
+      hdr.msg_namelen = sizeof(sockaddr_in);
+      hdr.msg_control = ring->control_[i].bytes;
+      hdr.msg_controllen = sizeof(ring->control_[i].bytes);
+      hdr.msg_flags = 0;
+    }
+    const int count = ::recvmmsg(fd_, ring->headers_.data(),
+                                 static_cast<unsigned int>(ring->capacity()),
+                                 MSG_DONTWAIT, nullptr);
+    if (count <= 0) {
+      return count;
+    }
+    // Map CLOCK_REALTIME kernel stamps into the steady clock domain using one
+    // paired reading per batch.
+    const auto steady_now = std::chrono::steady_clock::now();
+    const auto system_now = std::chrono::system_clock::now();
+    for (int i = 0; i < count; ++i) {
+      ring->lengths_[i] = ring->headers_[i].msg_len;
+      ring->truncated_[i] = (ring->headers_[i].msg_hdr.msg_flags & MSG_TRUNC) != 0;
+      ring->receive_times_[i] =
+          ReceiveTimeFromControl(&ring->headers_[i].msg_hdr, steady_now, system_now);
+    }
+    return count;
+#else
+    int count = 0;
+    const auto now = std::chrono::steady_clock::now();
+    while (static_cast<size_t>(count) < ring->capacity()) {
+      iovec iov{ring->data(count), ring->slot_size_};
+      msghdr hdr{};
+      hdr.msg_name = &ring->sources_[count];
+      hdr.msg_namelen = sizeof(sockaddr_in);
+      hdr.msg_iov = &iov;
+      hdr.msg_iovlen = 1;
+      const ssize_t bytes = ::recvmsg(fd_, &hdr, MSG_DONTWAIT);
+      if (bytes < 0) {
+        return count > 0 ? count : -1;
+      }
+      ring->lengths_[count] = static_cast<size_t>(bytes);
+      ring->truncated_[count] = (hdr.msg_flags & MSG_TRUNC) != 0;
+      ring->receive_times_[count] = now;
+      ++count;
+    }
+    return count;
+#endif
+  }
+
+ private:
+#ifdef __linux__
+  static constexpr int kRecvBufferForce = SO_RCVBUFFORCE;
+  static constexpr int kSendBufferForce = SO_SNDBUFFORCE;
+#else
+  static constexpr int kRecvBufferForce = 0;
+  static constexpr int kSendBufferForce = 0;
+#endif
+
+  // Request a buffer size, using the *FORCE variant to exceed the system
+  // maximum when privileged (CAP_NET_ADMIN) and falling back otherwise.
+  bool SetBufferSize(int option, int force_option, int bytes, const char* name) {
+    if (force_option != 0 &&
+        ::setsockopt(fd_, SOL_SOCKET, force_option, &bytes, sizeof(bytes)) == 0) {
+      return true;
+    }
+    if (::setsockopt(fd_, SOL_SOCKET, option, &bytes, sizeof(bytes)) < 0) {
+      last_error_ = "setsockopt(" + std::string(name) + ") failed: " +
+                    std::string(std::strerror(errno));
+      return false;
+    }
+    return true;
+  }
+
+  int fd_ = -1;
+  uint16_t port_ = 0;
+  uint8_t interface_index_ = 0;
+  std::string last_error_;
+};
+
+// Spin-wait hint for busy-poll loops.
+inline void CpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+  asm volatile("yield");
+#endif
 }
 
-// Validate the 10-byte magic header used by Pro DJ Link UDP packets.
-bool HasHeader(const uint8_t* data, size_t length) {
-  if (length < kHeaderSize) {
-    return false;
+// Readiness notification for the receive sockets. Uses edge-triggered
+// epoll with an eventfd wakeup on Linux, or select() with a self-pipe.
+class RecvReactor {
+ public:
+  static constexpr size_t kWakeTag = static_cast<size_t>(-1);
+
+  RecvReactor() = default;
+  ~RecvReactor() { Close(); }
+
+  RecvReactor(const RecvReactor&) = delete;
+  RecvReactor& operator=(const RecvReactor&) = delete;
+
+  bool Open(bool use_epoll) {
+    Close();
+#ifdef __linux__
+    if (use_epoll) {
+      epoll_fd_ = ::epoll_create1(EPOLL_CLOEXEC);
+      if (epoll_fd_ < 0) {
+        last_error_ = "epoll_create1() failed: " + std::string(std::strerror(errno));
+        return false;
+      }
+      wake_fd_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+      if (wake_fd_ < 0) {
+        last_error_ = "eventfd() failed: " + std::string(std::strerror(errno));
+        Close();
+        return false;
+      }
+      epoll_event event{};
+      event.events = EPOLLIN;
+      event.data.u64 = kWakeTag;
+      if (::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, wake_fd_, &event) < 0) {
+        last_error_ = "epoll_ctl(eventfd) failed: " + std::string(std::strerror(errno));
+        Close();
+        return false;
+      }
+      return true;
+    }
+#else
+    (void)use_epoll;
+#endif
+    int fds[2] = {-1, -1};
+    if (::pipe(fds) < 0) {
+      last_error_ = "pipe() failed: " + std::string(std::strerror(errno));
+      return false;
+    }
+    wake_fd_ = fds[0];
+    wake_write_fd_ = fds[1];
+    ::fcntl(wake_fd_, F_SETFL, ::fcntl(wake_fd_, F_GETFL) | O_NONBLOCK);
+    ::fcntl(wake_write_fd_, F_SETFL, ::fcntl(wake_write_fd_, F_GETFL) | O_NONBLOCK);
+    return true;
+  }
+
+  // Register a socket; tag is reported back by Wait() when it is readable.
+  bool Add(int fd, size_t tag) {
+#ifdef __linux__
+    if (epoll_fd_ >= 0) {
+      epoll_event event{};
+      event.events = EPOLLIN | EPOLLET;
+      event.data.u64 = tag;
+      if (::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event) < 0) {
+        last_error_ = "epoll_ctl() failed: " + std::string(std::strerror(errno));
+        return false;
+      }
+      return true;
+    }
+#endif
+    watched_.push_back({fd, tag});
+    return true;
+  }
+
+  // Block until a registered socket is readable or Wake() is called.
+  // Returns the number of ready tags, 0 on wakeup/interrupt, or -1 on error.
+  int Wait(std::vector<size_t>* ready) {
+    ready->clear();
+#ifdef __linux__
+    if (epoll_fd_ >= 0) {
+      epoll_event events[kMaxReactorEvents];
+      const int count = ::epoll_wait(epoll_fd_, events, kMaxReactorEvents, -1);
+      if (count < 0) {
+        return errno == EINTR ? 0 : -1;
+      }
+      for (int i = 0; i < count; ++i) {
+        if (events[i].data.u64 == kWakeTag) {
+          DrainWake();
+        } else {
+          ready->push_back(static_cast<size_t>(events[i].data.u64));
+        }
+      }
+      return static_cast<int>(ready->size());
+    }
+#endif
+    fd_set readfds;
+    FD_ZERO(&readfds);
+    int max_fd = wake_fd_;
+    FD_SET(wake_fd_, &readfds);
+    for (const auto& entry : watched_) {
+      FD_SET(entry.fd, &readfds);
+      max_fd = std::max(max_fd, entry.fd);
+    }
+    const int count = ::select(max_fd + 1, &readfds, nullptr, nullptr, nullptr);
+    if (count < 0) {
+      return errno == EINTR ? 0 : -1;
+    }
+    if (FD_ISSET(wake_fd_, &readfds)) {
+      DrainWake();
+    }
+    for (const auto& entry : watched_) {
+      if (FD_ISSET(entry.fd, &readfds)) {
+        ready->push_back(entry.tag);
+      }
+    }
+    return static_cast<int>(ready->size());
+  }
+
+  // Interrupt a blocked Wait() from another thread.
+  void Wake() {
+#ifdef __linux__
+    if (epoll_fd_ >= 0) {
+      const uint64_t one = 1;
+      (void)::write(wake_fd_, &one, sizeof(one));
+      return;
+    }
+#endif
+    if (wake_write_fd_ >= 0) {
+      const char byte = 1;
+      (void)::write(wake_write_fd_, &byte, sizeof(byte));
+    }
+  }
+
+  void Close() {
+    for (int* fd : {&epoll_fd_, &wake_fd_, &wake_write_fd_}) {
+      if (*fd >= 0) {
+        ::close(*fd);
+        *fd = -1;
+      }
+    }
+    watched_.clear();
+  }
+
+  const std::string& last_error() const { return last_error_; }
+
+ private:
+  struct Watched {
+    int fd;
+    size_t tag;
+  };
+
+  void DrainWake() {
+    uint64_t value = 0;
+    while (::read(wake_fd_, &value, sizeof(value)) > 0) {
+    }
+  }
+
+  int epoll_fd_ = -1;
+  int wake_fd_ = -1;
+  int wake_write_fd_ = -1;
+  std::vector<Watched> watched_;
+  std::string last_error_;
+};
+
+#ifdef __linux__
+// Passive AF_PACKET capture of Pro DJ Link UDP traffic using a TPACKET_V3
+// mmap ring. Frames are handed out in place; nothing is copied per frame.
+class PacketSniffer {
+ public:
+  using FrameHandler =
+      std::function<void(const uint8_t* data, size_t length, const sockaddr_in& source,
+                         uint16_t destination_port,
+                         std::chrono::steady_clock::time_point receive_time,
+                         bool truncated)>;
+
+  PacketSniffer() = default;
+  ~PacketSniffer() { Close(); }
+
+  PacketSniffer(const PacketSniffer&) = delete;
+  PacketSniffer& operator=(const PacketSniffer&) = delete;
+
+  bool Open(const std::string& interface_name) {
+    Close();
+    const unsigned int ifindex = ::if_nametoindex(interface_name.c_str());
+    if (ifindex == 0) {
+      last_error_ = "unknown monitor interface: " + interface_name;
+      return false;
+    }
+    fd_ = ::socket(AF_PACKET, SOCK_RAW, htons(ETH_P_IP));
+    if (fd_ < 0) {
+      last_error_ = "socket(AF_PACKET) failed: " + std::string(std::strerror(errno));
+      return false;
+    }
+    if (!AttachFilter()) {
+      return false;
+    }
+    int version = TPACKET_V3;
+    if (::setsockopt(fd_, SOL_PACKET, PACKET_VERSION, &version, sizeof(version)) < 0) {
+      return Fail("setsockopt(PACKET_VERSION)");
+    }
+    tpacket_req3 req{};
+    req.tp_block_size = kMonitorBlockSize;
+    req.tp_block_nr = kMonitorBlockCount;
+    req.tp_frame_size = kMonitorFrameSize;
+    req.tp_frame_nr = (kMonitorBlockSize / kMonitorFrameSize) * kMonitorBlockCount;
+    req.tp_retire_blk_tov = kMonitorBlockTimeoutMs;
+    if (::setsockopt(fd_, SOL_PACKET, PACKET_RX_RING, &req, sizeof(req)) < 0) {
+      return Fail("setsockopt(PACKET_RX_RING)");
+    }
+    ring_size_ = static_cast<size_t>(kMonitorBlockSize) * kMonitorBlockCount;
+    void* ring = ::mmap(nullptr, ring_size_, PROT_READ | PROT_WRITE,
+                        MAP_SHARED | MAP_LOCKED, fd_, 0);
+    if (ring == MAP_FAILED) {
+      // MAP_LOCKED needs RLIMIT_MEMLOCK headroom; retry unlocked.
+      ring = ::mmap(nullptr, ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    }
+    if (ring == MAP_FAILED) {
+      return Fail("mmap(PACKET_RX_RING)");
+    }
+    ring_ = static_cast<uint8_t*>(ring);
+    sockaddr_ll addr{};
+    addr.sll_family = AF_PACKET;
+    addr.sll_protocol = htons(ETH_P_IP);
+    addr.sll_ifindex = static_cast<int>(ifindex);
+    if (::bind(fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+      return Fail("bind(AF_PACKET)");
+    }
+    next_block_ = 0;
+    return true;
+  }
+
+  void Close() {
+    if (ring_) {
+      ::munmap(ring_, ring_size_);
+      ring_ = nullptr;
+    }
+    if (fd_ >= 0) {
+      ::close(fd_);
+      fd_ = -1;
+    }
+  }
+
+  int fd() const { return fd_; }
+  const std::string& last_error() const { return last_error_; }
+
+  // Walk every block the kernel has handed to user space, then return the
+  // blocks. Returns the number of UDP payloads delivered.
+  int Drain(const FrameHandler& on_frame) {
+    int delivered = 0;
+    while (ring_) {
+      auto* block = reinterpret_cast<tpacket_block_desc*>(
+          ring_ + static_cast<size_t>(next_block_) * kMonitorBlockSize);
+      if ((__atomic_load_n(&block->hdr.bh1.block_status, __ATOMIC_ACQUIRE) &
+           TP_STATUS_USER) == 0) {
+        break;
+      }
+      const auto steady_now = std::chrono::steady_clock::now();
+      const auto system_now = std::chrono::system_clock::now();
+      const uint32_t count = block->hdr.bh1.num_pkts;
+      const uint8_t* frame =
+          reinterpret_cast<const uint8_t*>(block) + block->hdr.bh1.offset_to_first_pkt;
+      for (uint32_t i = 0; i < count; ++i) {
+        const auto* hdr = reinterpret_cast<const tpacket3_hdr*>(frame);
+        delivered += DeliverFrame(frame, *hdr, steady_now, system_now, on_frame);
+        frame += hdr->tp_next_offset;
+      }
+      __atomic_store_n(&block->hdr.bh1.block_status, TP_STATUS_KERNEL, __ATOMIC_RELEASE);
+      next_block_ = (next_block_ + 1) % kMonitorBlockCount;
+    }
+    return delivered;
+  }
+
+  // Frames the kernel dropped because the ring was full, since Open().
+  uint64_t Drops() const {
+    if (fd_ >= 0) {
+      tpacket_stats_v3 stats{};
+      socklen_t len = sizeof(stats);
+      // PACKET_STATISTICS resets the kernel counters on every read.
+      if (::getsockopt(fd_, SOL_PACKET, PACKET_STATISTICS, &stats, &len) == 0) {
+        drops_.fetch_add(stats.tp_drops);
+      }
+    }
+    return drops_.load();
+  }
+
+ private:
+  bool Fail(const char* what) {
+    last_error_ = std::string(what) + " failed: " + std::strerror(errno);
+    Close();
+    return false;
+  }
+
+  // Keep only unfragmented IPv4/UDP frames addressed to ports 50000-50002.
+  bool AttachFilter() {
+    static sock_filter code[] = {
+        {BPF_LD | BPF_H | BPF_ABS, 0, 0, 12},
+        {BPF_JMP | BPF_JEQ | BPF_K, 0, 8, ETHERTYPE_IP},
+        {BPF_LD | BPF_B | BPF_ABS, 0, 0, 23},
+        {BPF_JMP | BPF_JEQ | BPF_K, 0, 6, IPPROTO_UDP},
+        {BPF_LD | BPF_H | BPF_ABS, 0, 0, 20},
+        {BPF_JMP | BPF_JSET | BPF_K, 4, 0, 0x1fff},
+        {BPF_LDX | BPF_B | BPF_MSH, 0, 0, 14},
+        {BPF_LD | BPF_H | BPF_IND, 0, 0, 16},
+        {BPF_JMP | BPF_JGE | BPF_K, 0, 1, kAnnouncePort},
+        {BPF_JMP | BPF_JGT | BPF_K, 0, 1, kStatusPort},
+        {BPF_RET | BPF_K, 0, 0, 0},
+        {BPF_RET | BPF_K, 0, 0, 0x40000},
+    };
+    sock_fprog program{};
+    program.len = sizeof(code) / sizeof(code[0]);
+    program.filter = code;
+    if (::setsockopt(fd_, SOL_SOCKET, SO_ATTACH_FILTER, &program, sizeof(program)) < 0) {
+      return Fail("setsockopt(SO_ATTACH_FILTER)");
+    }
+    return true;
+  }
+
+  static int DeliverFrame(const uint8_t* frame, const tpacket3_hdr& hdr,
+                          std::chrono::steady_clock::time_point steady_now,
+                          std::chrono::system_clock::time_point system_now,
+                          const FrameHandler& on_frame) {
+    const auto* link = reinterpret_cast<const sockaddr_ll*>(
+        frame + TPACKET_ALIGN(sizeof(tpacket3_hdr)));
+    // Our own transmissions show up as outgoing frames; skip them.
+    if (link->sll_pkttype == PACKET_OUTGOING) {
+      return 0;
+    }
+    const uint8_t* mac = frame + hdr.tp_mac;
+    const size_t caplen = hdr.tp_snaplen;
+    if (caplen < kEthernetHeaderSize + kIpv4MinHeaderSize + kUdpHeaderSize) {
+      return 0;
+    }
+    const uint8_t* ip = mac + kEthernetHeaderSize;
+    const size_t ip_header = static_cast<size_t>(ip[0] & 0x0f) * 4;
+    if (ip_header < kIpv4MinHeaderSize ||
+        caplen < kEthernetHeaderSize + ip_header + kUdpHeaderSize) {
+      return 0;
+    }
+    const uint8_t* udp = ip + ip_header;
+    const size_t udp_length = ReadBe16(udp, 4);
+    if (udp_length < kUdpHeaderSize) {
+      return 0;
+    }
+    const size_t available = caplen - kEthernetHeaderSize - ip_header - kUdpHeaderSize;
+    const size_t payload_length = std::min(udp_length - kUdpHeaderSize, available);
+    sockaddr_in source{};
+    source.sin_family = AF_INET;
+    std::memcpy(&source.sin_port, udp, sizeof(source.sin_port));
+    std::memcpy(&source.sin_addr, ip + 12, sizeof(source.sin_addr));
+    timespec stamp{};
+    stamp.tv_sec = hdr.tp_sec;
+    stamp.tv_nsec = hdr.tp_nsec;
+    on_frame(udp + kUdpHeaderSize, payload_length, source, ReadBe16(udp, 2),
+             SteadyFromRealtime(stamp, steady_now, system_now),
+             payload_length < udp_length - kUdpHeaderSize);
+    return 1;
+  }
+
+  int fd_ = -1;
+  uint8_t* ring_ = nullptr;
+  size_t ring_size_ = 0;
+  uint32_t next_block_ = 0;
+  mutable std::atomic<uint64_t> drops_{0};
+  std::string last_error_;
+};
+#endif
+
+#ifdef PROLINK_HAVE_IO_URING
+constexpr unsigned kIoUringEntries = 256;
+constexpr unsigned kIoUringBufferCount = 256;
+constexpr uint16_t kIoUringBufferGroup = 0;
+constexpr unsigned kIoUringSendSlots = 64;
+
+// Minimal io_uring wrapper over the raw syscalls. Keeps a multishot recvmsg
+// armed on every listening socket with a provided buffer ring, and accepts
+// sendmsg submissions from any thread. Completions for both are reaped by the
+// receive thread in WaitAndDispatch().
+class IoUringReactor {
+ public:
+  using RecvHandler =
+      std::function<void(const uint8_t* data, size_t length, const sockaddr_in& source,
+                         uint16_t local_port, uint8_t interface_index,
+                         std::chrono::steady_clock::time_point receive_time,
+                         bool truncated)>;
+  using SendHandler =
+      std::function<void(const char* packet_type, ssize_t result, size_t expected)>;
+
+  IoUringReactor() = default;
+  ~IoUringReactor() { Close(); }
+
+  IoUringReactor(const IoUringReactor&) = delete;
+  IoUringReactor& operator=(const IoUringReactor&) = delete;
+
+  bool Open() {
+    io_uring_params params{};
+    ring_fd_ = static_cast<int>(::syscall(__NR_io_uring_setup, kIoUringEntries, &params));
+    if (ring_fd_ < 0) {
+      last_error_ = "io_uring_setup() failed: " + std::string(std::strerror(errno));
+      return false;
+    }
+    sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    const bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single_mmap) {
+      sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+    }
+    sq_ring_ = ::mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQ_RING);
+    if (sq_ring_ == MAP_FAILED) {
+      sq_ring_ = nullptr;
+      return Fail("mmap(sq ring)");
+    }
+    if (single_mmap) {
+      cq_ring_ = sq_ring_;
+    } else {
+      cq_ring_ = ::mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE,
+                        MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_CQ_RING);
+      if (cq_ring_ == MAP_FAILED) {
+        cq_ring_ = nullptr;
+        return Fail("mmap(cq ring)");
+      }
+    }
+    sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+    sqes_ = static_cast<io_uring_sqe*>(::mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE,
+                                              MAP_SHARED | MAP_POPULATE, ring_fd_,
+                                              IORING_OFF_SQES));
+    if (sqes_ == MAP_FAILED) {
+      sqes_ = nullptr;
+      return Fail("mmap(sqes)");
+    }
+    auto* sq = static_cast<uint8_t*>(sq_ring_);
+    sq_head_ = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+    sq_tail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+    sq_mask_ = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+    sq_entries_ = params.sq_entries;
+    sq_array_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+    auto* cq = static_cast<uint8_t*>(cq_ring_);
+    cq_head_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+    cq_tail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+    cq_mask_ = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+    cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+
+    if (!SetupBufferRing()) {
+      return false;
+    }
+    send_slots_.reset(new SendSlot[kIoUringSendSlots]);
+    free_send_slots_.clear();
+    for (unsigned i = 0; i < kIoUringSendSlots; ++i) {
+      free_send_slots_.push_back(i);
+    }
+    std::memset(&recv_msg_, 0, sizeof(recv_msg_));
+    recv_msg_.msg_namelen = sizeof(sockaddr_in);
+    recv_msg_.msg_controllen = kRecvControlSize;
+    stopping_ = false;
+    return true;
+  }
+
+  // Arm a multishot recvmsg on a listening socket.
+  bool AddReceiver(UdpSocket* socket) {
+    std::lock_guard<std::mutex> lock(sq_mutex_);
+    receivers_.push_back(socket);
+    if (!ArmReceiveLocked(receivers_.size() - 1)) {
+      last_error_ = "io_uring recvmsg submit failed: " + std::string(std::strerror(errno));
+      return false;
+    }
+    return true;
   }
-  return std::memcmp(data, kProlinkHeader, kHeaderSize) == 0;
-}
 
-// Extract and trim the 20-byte device name field at a specific offset.
-std::string ParseDeviceNameAt(const uint8_t* data, size_t length, size_t offset) {
-  if (length < offset + kDeviceNameLength) {
-    return {};
+  // Queue a sendmsg. Returns false if the caller should fall back to sendto();
+  // once the SQE is queued the send belongs to the ring.
+  bool Send(int fd, const uint8_t* data, size_t size, const sockaddr_in& addr,
+            const char* packet_type) {
+    if (size > kMaxSendPacketSize) {
+      return false;
+    }
+    std::lock_guard<std::mutex> lock(sq_mutex_);
+    if (ring_fd_ < 0 || stopping_ || free_send_slots_.empty()) {
+      return false;
+    }
+    const unsigned index = free_send_slots_.back();
+    SendSlot& slot = send_slots_[index];
+    std::memcpy(slot.data.data(), data, size);
+    slot.addr = addr;
+    slot.iov.iov_base = slot.data.data();
+    slot.iov.iov_len = size;
+    std::memset(&slot.msg, 0, sizeof(slot.msg));
+    slot.msg.msg_name = &slot.addr;
+    slot.msg.msg_namelen = sizeof(slot.addr);
+    slot.msg.msg_iov = &slot.iov;
+    slot.msg.msg_iovlen = 1;
+    slot.packet_type = packet_type;
+    slot.size = size;
+
+    io_uring_sqe* sqe = NextSqeLocked();
+    if (!sqe) {
+      return false;
+    }
+    sqe->opcode = IORING_OP_SENDMSG;
+    sqe->fd = fd;
+    sqe->addr = reinterpret_cast<uint64_t>(&slot.msg);
+    sqe->len = 1;
+    sqe->user_data = Encode(kSendKind, index);
+    free_send_slots_.pop_back();
+    CommitLocked();
+    return true;
   }
-  std::string name(reinterpret_cast<const char*>(data + offset),
-                   kDeviceNameLength);
-  auto null_pos = name.find('\0');
-  if (null_pos != std::string::npos) {
-    name.resize(null_pos);
+
+  // Wait for at least one completion and dispatch everything queued.
+  // Returns the number of datagrams delivered, or -1 on error.
+  // Also submits SQEs left queued by a failed submit.
+  int WaitAndDispatch(const RecvHandler& on_recv, const SendHandler& on_send) {
+    // EAGAIN and EBUSY only mean the queued SQEs could not be submitted yet;
+    // reaping completions below makes room for them.
+    if (::syscall(__NR_io_uring_enter, ring_fd_, sq_entries_, 1, IORING_ENTER_GETEVENTS,
+                  nullptr, 0) < 0 &&
+        errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+      return -1;
+    }
+    int delivered = 0;
+    const auto steady_now = std::chrono::steady_clock::now();
+    const auto system_now = std::chrono::system_clock::now();
+    unsigned head = *cq_head_;
+    const unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+    for (; head != tail; ++head) {
+      const io_uring_cqe cqe = cqes_[head & cq_mask_];
+      const uint64_t kind = cqe.user_data >> 56;
+      const size_t value = static_cast<size_t>(cqe.user_data & 0xffffffffu);
+      if (kind == kSendKind) {
+        const char* packet_type = nullptr;
+        size_t expected = 0;
+        {
+          std::lock_guard<std::mutex> lock(sq_mutex_);
+          packet_type = send_slots_[value].packet_type;
+          expected = send_slots_[value].size;
+          free_send_slots_.push_back(static_cast<unsigned>(value));
+        }
+        if (cqe.res < 0) {
+          errno = -cqe.res;
+        }
+        on_send(packet_type, cqe.res, expected);
+        continue;
+      }
+      if (kind != kRecvKind) {
+        continue;
+      }
+      if (cqe.res >= 0 && (cqe.flags & IORING_CQE_F_BUFFER) != 0) {
+        const uint16_t bid = static_cast<uint16_t>(cqe.flags >> IORING_CQE_BUFFER_SHIFT);
+        delivered += DispatchReceive(receivers_[value], bid, static_cast<size_t>(cqe.res),
+                                     steady_now, system_now, on_recv);
+        RecycleBuffer(bid);
+      }
+      if ((cqe.flags & IORING_CQE_F_MORE) == 0) {
+        std::lock_guard<std::mutex> lock(sq_mutex_);
+        if (!stopping_) {
+          ArmReceiveLocked(value);
+        }
+      }
+    }
+    __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+    return delivered;
   }
-  // Device names are space-padded in packets; preserve intentional leading spaces.
-  while (!name.empty() && name.back() == ' ') {
-    name.pop_back();
+
+  // Interrupt a blocked WaitAndDispatch() and stop re-arming receives.
+  void Wake() {
+    std::lock_guard<std::mutex> lock(sq_mutex_);
+    if (ring_fd_ < 0) {
+      return;
+    }
+    stopping_ = true;
+    io_uring_sqe* sqe = NextSqeLocked();
+    if (!sqe) {
+      return;
+    }
+    sqe->opcode = IORING_OP_NOP;
+    sqe->user_data = Encode(kWakeKind, 0);
+    CommitLocked();
   }
-  return name;
-}
 
-// Extract and trim the 20-byte device name field.
-std::string ParseDeviceName(const uint8_t* data, size_t length) {
-  return ParseDeviceNameAt(data, length, kDeviceNameOffset);
-}
+  void Close() {
+    std::lock_guard<std::mutex> lock(sq_mutex_);
+    if (buffer_ring_) {
+      ::munmap(buffer_ring_, buffer_ring_size_);
+      buffer_ring_ = nullptr;
+    }
+    if (sqes_) {
+      ::munmap(sqes_, sqes_size_);
+      sqes_ = nullptr;
+    }
+    if (cq_ring_ && cq_ring_ != sq_ring_) {
+      ::munmap(cq_ring_, cq_ring_size_);
+    }
+    cq_ring_ = nullptr;
+    if (sq_ring_) {
+      ::munmap(sq_ring_, sq_ring_size_);
+      sq_ring_ = nullptr;
+    }
+    if (ring_fd_ >= 0) {
+      ::close(ring_fd_);
+      ring_fd_ = -1;
+    }
+    receivers_.clear();
+    free_send_slots_.clear();
+  }
 
-// Build a standard packet with magic header + type + device name + payload.
-std::vector<uint8_t> BuildPacket(PacketType type,
-                                 const std::string& device_name,
-                                 const std::vector<uint8_t>& payload) {
-  std::vector<uint8_t> packet;
-  packet.reserve(kPayloadOffset + payload.size());
-  packet.insert(packet.end(), kProlinkHeader, kProlinkHeader + kHeaderSize);
-  packet.push_back(static_cast<uint8_t>(type));
+  const std::string& last_error() const { return last_error_; }
 
-  std::array<uint8_t, kDeviceNameLength> name_bytes{};
-  const size_t copy_len = std::min(device_name.size(), name_bytes.size());
-  std::memcpy(name_bytes.data(), device_name.data(), copy_len);
-  packet.insert(packet.end(), name_bytes.begin(), name_bytes.end());
-  packet.insert(packet.end(), payload.begin(), payload.end());
-  return packet;
-}
+ private:
+  static constexpr uint64_t kRecvKind = 1;
+  static constexpr uint64_t kSendKind = 2;
+  static constexpr uint64_t kWakeKind = 3;
+
+  struct SendSlot {
+    std::array<uint8_t, kMaxSendPacketSize> data{};
+    sockaddr_in addr{};
+    iovec iov{};
+    msghdr msg{};
+    const char* packet_type = nullptr;
+    size_t size = 0;
+  };
 
-// Build a keep-alive/announce packet for port 50000 broadcast.
-std::vector<uint8_t> BuildAnnouncePacket(const Config& config) {
-  std::array<uint8_t, 4> ip_bytes{};
-  if (!config.device_ip.empty()) {
-    in_addr addr{};
-    if (inet_pton(AF_INET, config.device_ip.c_str(), &addr) == 1) {
-      std::memcpy(ip_bytes.data(), &addr, ip_bytes.size());
-    }
-  }
-
-  std::array<uint8_t, kDeviceNameLength> name_bytes{};
-  const size_t copy_len = std::min(config.device_name.size(), name_bytes.size());
-  std::memcpy(name_bytes.data(), config.device_name.data(), copy_len);
-
-  std::vector<uint8_t> packet;
-  packet.reserve(0x36);
-  packet.insert(packet.end(), kProlinkHeader, kProlinkHeader + kHeaderSize);
-  packet.push_back(0x06);
-  packet.push_back(0x00);
-  packet.insert(packet.end(), name_bytes.begin(), name_bytes.end());
-  packet.push_back(0x01);
-  packet.push_back(0x02);
-  packet.push_back(0x00);
-  packet.push_back(0x36);
-  packet.push_back(config.device_number);
-  packet.push_back(config.device_type);
-  packet.insert(packet.end(), config.mac_address.begin(), config.mac_address.end());
-  packet.insert(packet.end(), ip_bytes.begin(), ip_bytes.end());
-  packet.push_back(0x01);
-  packet.push_back(0x00);
-  packet.push_back(0x00);
-  packet.push_back(0x00);
-  packet.push_back(config.device_type);
-  packet.push_back(0x00);
-  return packet;
-}
+  static uint64_t Encode(uint64_t kind, size_t value) {
+    return (kind << 56) | static_cast<uint64_t>(value);
+  }
 
-// Convert a string address and port into a sockaddr_in.
-sockaddr_in MakeSockaddr(const std::string& address, uint16_t port) {
-  sockaddr_in addr{};
-  addr.sin_family = AF_INET;
-  addr.sin_port = htons(port);
-  if (address.empty() || address == "0.0.0.0") {
-    addr.sin_addr.s_addr = htonl(INADDR_ANY);
-  } else {
-    if (inet_pton(AF_INET, address.c_str(), &addr.sin_addr) != 1) {
-      addr.sin_addr.s_addr = htonl(INADDR_ANY);
-    }
+  // Provided buffers are shared by all ports, so size them for the largest.
+  static size_t BufferSize() {
+    return sizeof(io_uring_recvmsg_out) + sizeof(sockaddr_in) + kRecvControlSize +
+           kMaxStatusPortPacket;
   }
-  return addr;
-}
 
-// Minimal UDP socket wrapper for send/recv with broadcast support.
-class UdpSocket {
- public:
-  UdpSocket() = default;
-  ~UdpSocket() { Close(); }
+  bool Fail(const char* what) {
+    last_error_ = std::string(what) + " failed: " + std::strerror(errno);
+    Close();
+    return false;
+  }
 
-  bool Open(uint16_t port, const std::string& bind_address, bool allow_broadcast) {
-    if (fd_ >= 0) {
-      return true;
-    }
-    fd_ = ::socket(AF_INET, SOCK_DGRAM, 0);
-    if (fd_ < 0) {
-      last_error_ = "socket() failed: " + std::string(std::strerror(errno));
-      return false;
-    }
-    int reuse = 1;
-    if (::setsockopt(fd_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse)) < 0) {
-      last_error_ = "setsockopt(SO_REUSEADDR) failed: " + std::string(std::strerror(errno));
-      Close();
-      return false;
+  bool SetupBufferRing() {
+    buffer_ring_size_ = kIoUringBufferCount * sizeof(io_uring_buf);
+    buffer_ring_ = ::mmap(nullptr, buffer_ring_size_, PROT_READ | PROT_WRITE,
+                          MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (buffer_ring_ == MAP_FAILED) {
+      buffer_ring_ = nullptr;
+      return Fail("mmap(buffer ring)");
     }
-    if (allow_broadcast) {
-      int broadcast = 1;
-      if (::setsockopt(fd_, SOL_SOCKET, SO_BROADCAST, &broadcast, sizeof(broadcast)) < 0) {
-        last_error_ = "setsockopt(SO_BROADCAST) failed: " + std::string(std::strerror(errno));
-        Close();
-        return false;
-      }
+    io_uring_buf_reg reg{};
+    reg.ring_addr = reinterpret_cast<uint64_t>(buffer_ring_);
+    reg.ring_entries = kIoUringBufferCount;
+    reg.bgid = kIoUringBufferGroup;
+    if (::syscall(__NR_io_uring_register, ring_fd_, IORING_REGISTER_PBUF_RING, &reg, 1) < 0) {
+      return Fail("io_uring_register(PBUF_RING)");
     }
-    sockaddr_in addr = MakeSockaddr(bind_address, port);
-    if (::bind(fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
-      std::ostringstream oss;
-      oss << "bind(" << bind_address << ":" << port << ") failed: "
-          << std::strerror(errno);
-      last_error_ = oss.str();
-      Close();
-      return false;
+    buffers_.assign(kIoUringBufferCount * BufferSize(), 0);
+    buffer_tail_ = 0;
+    for (unsigned i = 0; i < kIoUringBufferCount; ++i) {
+      RecycleBuffer(static_cast<uint16_t>(i));
     }
     return true;
   }
 
-  void Close() {
-    if (fd_ >= 0) {
-      ::close(fd_);
-      fd_ = -1;
+  // Hand a buffer back to the kernel. Only the receive thread recycles.
+  void RecycleBuffer(uint16_t bid) {
+    auto* bufs = static_cast<io_uring_buf*>(buffer_ring_);
+    io_uring_buf& buf = bufs[buffer_tail_ & (kIoUringBufferCount - 1)];
+    buf.addr = reinterpret_cast<uint64_t>(buffers_.data() + bid * BufferSize());
+    buf.len = static_cast<uint32_t>(BufferSize());
+    buf.bid = bid;
+    ++buffer_tail_;
+    // The ring tail aliases the reserved field of the first entry.
+    __atomic_store_n(&bufs[0].resv, buffer_tail_, __ATOMIC_RELEASE);
+  }
+
+  int DispatchReceive(UdpSocket* receiver, uint16_t bid, size_t used,
+                      std::chrono::steady_clock::time_point steady_now,
+                      std::chrono::system_clock::time_point system_now,
+                      const RecvHandler& on_recv) {
+    uint8_t* base = buffers_.data() + bid * BufferSize();
+    io_uring_recvmsg_out out{};
+    std::memcpy(&out, base, sizeof(out));
+    const size_t payload_offset =
+        sizeof(io_uring_recvmsg_out) + recv_msg_.msg_namelen + recv_msg_.msg_controllen;
+    if (used <= payload_offset) {
+      return 0;
     }
+    sockaddr_in source{};
+    std::memcpy(&source, base + sizeof(io_uring_recvmsg_out),
+                std::min<size_t>(out.namelen, sizeof(source)));
+    msghdr control{};
+    control.msg_control = base + sizeof(io_uring_recvmsg_out) + recv_msg_.msg_namelen;
+    control.msg_controllen = out.controllen;
+    const auto receive_time = ReceiveTimeFromControl(&control, steady_now, system_now);
+    on_recv(base + payload_offset, used - payload_offset, source, receiver->port(),
+            receiver->interface_index(), receive_time, (out.flags & MSG_TRUNC) != 0);
+    return 1;
   }
 
-  int fd() const { return fd_; }
-  const std::string& last_error() const { return last_error_; }
+  // Next free SQE, cleared. The kernel only sees it after CommitLocked().
+  io_uring_sqe* NextSqeLocked() {
+    const unsigned head = __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE);
+    const unsigned tail = *sq_tail_;
+    if (tail - head >= sq_entries_) {
+      return nullptr;
+    }
+    const unsigned index = tail & sq_mask_;
+    io_uring_sqe* sqe = &sqes_[index];
+    std::memset(sqe, 0, sizeof(*sqe));
+    sq_array_[index] = index;
+    return sqe;
+  }
 
-  ssize_t SendTo(const std::vector<uint8_t>& data, const sockaddr_in& addr) {
-    return ::sendto(fd_, data.data(), data.size(), 0,
-                    reinterpret_cast<const sockaddr*>(&addr), sizeof(addr));
+  // Publish the SQE from NextSqeLocked() and submit everything queued. A
+  // published SQE is never taken back: if io_uring_enter fails (EAGAIN,
+  // EBUSY) it stays queued for the next enter, including the receive
+  // thread's wait, so callers must neither fall back nor reuse its buffers.
+  void CommitLocked() {
+    __atomic_store_n(sq_tail_, *sq_tail_ + 1, __ATOMIC_RELEASE);
+    while (::syscall(__NR_io_uring_enter, ring_fd_, sq_entries_, 0, 0, nullptr, 0) < 0 &&
+           errno == EINTR) {
+    }
   }
 
-  ssize_t RecvFrom(uint8_t* buffer, size_t length, sockaddr_in* addr,
-                   socklen_t* addr_len) {
-    return ::recvfrom(fd_, buffer, length, 0,
-                      reinterpret_cast<sockaddr*>(addr), addr_len);
+  bool ArmReceiveLocked(size_t receiver) {
+    io_uring_sqe* sqe = NextSqeLocked();
+    if (!sqe) {
+      errno = EBUSY;
+      return false;
+    }
+    sqe->opcode = IORING_OP_RECVMSG;
+    sqe->fd = receivers_[receiver]->fd();
+    sqe->addr = reinterpret_cast<uint64_t>(&recv_msg_);
+    sqe->len = 1;
+    sqe->ioprio = IORING_RECV_MULTISHOT;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = kIoUringBufferGroup;
+    sqe->user_data = Encode(kRecvKind, receiver);
+    CommitLocked();
+    return true;
   }
 
- private:
-  int fd_ = -1;
+  int ring_fd_ = -1;
+  void* sq_ring_ = nullptr;
+  void* cq_ring_ = nullptr;
+  size_t sq_ring_size_ = 0;
+  size_t cq_ring_size_ = 0;
+  io_uring_sqe* sqes_ = nullptr;
+  size_t sqes_size_ = 0;
+  unsigned* sq_head_ = nullptr;
+  unsigned* sq_tail_ = nullptr;
+  unsigned* sq_array_ = nullptr;
+  unsigned sq_mask_ = 0;
+  unsigned sq_entries_ = 0;
+  unsigned* cq_head_ = nullptr;
+  unsigned* cq_tail_ = nullptr;
+  unsigned cq_mask_ = 0;
+  io_uring_cqe* cqes_ = nullptr;
+
+  void* buffer_ring_ = nullptr;
+  size_t buffer_ring_size_ = 0;
+  uint16_t buffer_tail_ = 0;
+  std::vector<uint8_t> buffers_;
+  msghdr recv_msg_{};
+
+  std::mutex sq_mutex_;
+  bool stopping_ = false;
+  std::vector<UdpSocket*> receivers_;
+  std::unique_ptr<SendSlot[]> send_slots_;
+  std::vector<unsigned> free_send_slots_;
   std::string last_error_;
 };
+#endif
 
 // Snapshot of the local beat clock at a point in time.
 struct BeatSnapshot {
@@ -415,164 +1588,498 @@ class BeatClock {
 
 // Parse a beat packet (0x60 bytes) into BeatInfo.
 bool ParseBeat(const uint8_t* data, size_t length, BeatInfo* out) {
-  if (!out || length < kBeatPacketSize || !HasHeader(data, length)) {
-    return false;
-  }
-  if (data[kPacketTypeOffset] != static_cast<uint8_t>(PacketType::kBeat)) {
+  const BeatView view(data, length);
+  if (!out || !view.valid()) {
     return false;
   }
-  // Safe because we checked length >= kBeatPacketSize.
-  out->device_name = ParseDeviceName(data, length);
-  out->device_number = data[kOffsetDeviceNumber];
-  out->pitch = ReadBe24(data, kOffsetBeatPitch);
-  out->bpm = ReadBe16(data, kOffsetBeatBpm);
-  out->beat_within_bar = data[kOffsetBeatWithinBar];
-  // Sanitize beat_within_bar to valid range (1-8, common values are 1-4)
-  if (out->beat_within_bar < 1 || out->beat_within_bar > 8) {
-    out->beat_within_bar = 1;
-  }
-  out->next_beat_ms = ReadBe32(data, kOffsetBeatNext);
-  out->next_bar_ms = ReadBe32(data, kOffsetBeatNextBar);
+  *out = Materialize(view);
   return true;
 }
 
 // Parse a CDJ status packet into StatusInfo using common offsets.
 bool ParseStatus(const uint8_t* data, size_t length, StatusInfo* out) {
-  if (!out || length < kStatusMinimumSize || !HasHeader(data, length)) {
+  const StatusView view(data, length);
+  if (!out || !view.valid()) {
     return false;
   }
-  if (data[kPacketTypeOffset] != static_cast<uint8_t>(PacketType::kCdjStatus)) {
+  *out = Materialize(view);
+  return true;
+}
+
+// Convert percent (-100..+100) into raw pitch value.
+uint32_t PitchFromPercent(double percent) {
+  return static_cast<uint32_t>(
+      std::lround(percent * kNeutralPitch / 100.0) + kNeutralPitch);
+}
+
+struct KeepAliveInfo {
+  uint8_t device_number = 0;
+  uint8_t device_type = 0;
+  // Points into the packet (or the caller's string); not owned.
+  std::string_view device_name;
+  // Network byte order; 0 if unset.
+  uint32_t ip_address = 0;
+  std::array<uint8_t, 6> mac_address = {0, 0, 0, 0, 0, 0};
+};
+
+// Token buckets per (source address, device number, packet type), checked
+// right after the header check so floods are shed before parsing.
+class RateLimiter {
+ public:
+  explicit RateLimiter(const std::map<PacketType, RateLimit>& limits) {
+    for (const auto& entry : limits) {
+      limits_[static_cast<uint8_t>(entry.first)] = entry.second;
+      limited_[static_cast<uint8_t>(entry.first)] = true;
+    }
+  }
+
+  // Returns false if the packet should be dropped.
+  bool Allow(uint8_t type, uint32_t source, uint8_t device,
+             std::chrono::steady_clock::time_point now) {
+    if (!limited_[type]) {
+      return true;
+    }
+    const RateLimit& limit = limits_[type];
+    const uint64_t key = (static_cast<uint64_t>(source) << 16) |
+                         (static_cast<uint64_t>(device) << 8) | type;
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = buckets_.find(key);
+    if (it == buckets_.end()) {
+      if (buckets_.size() >= kMaxRateLimitBuckets) {
+        // Too many distinct sources to track until EvictIdle() makes room:
+        // treat as one flood.
+        ++untracked_drops_;
+        return false;
+      }
+      it = buckets_.emplace(key, Bucket{limit.burst, now, 0}).first;
+      // A returning source keeps the drops counted before it went idle.
+      auto evicted = evicted_drops_.find(key);
+      if (evicted != evicted_drops_.end()) {
+        it->second.dropped = evicted->second;
+        evicted_drops_.erase(evicted);
+      }
+    }
+    Bucket& bucket = it->second;
+    // Receive times from different sockets may arrive slightly out of order.
+    if (now > bucket.last) {
+      const double elapsed = std::chrono::duration<double>(now - bucket.last).count();
+      bucket.tokens = std::min(limit.burst, bucket.tokens + elapsed * limit.packets_per_second);
+      bucket.last = now;
+    }
+    if (bucket.tokens < 1.0) {
+      ++bucket.dropped;
+      return false;
+    }
+    bucket.tokens -= 1.0;
+    return true;
+  }
+
+  void Report(SessionMetrics* metrics) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    metrics->rate_limited = untracked_drops_;
+    for (const auto& entry : buckets_) {
+      AddSource(entry.first, entry.second.dropped, metrics);
+    }
+    for (const auto& entry : evicted_drops_) {
+      AddSource(entry.first, entry.second, metrics);
+    }
+  }
+
+  // Forget sources that stopped sending. Called from the prune thread so
+  // Allow() never scans the table. Drops counted by an evicted bucket stay
+  // reported for its source, or in the untracked total once
+  // kMaxRateLimitBuckets sources are remembered that way.
+  void EvictIdle(std::chrono::steady_clock::time_point now) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto it = buckets_.begin(); it != buckets_.end();) {
+      if (now - it->second.last <= kRateLimitIdleTimeout) {
+        ++it;
+        continue;
+      }
+      if (it->second.dropped > 0) {
+        if (evicted_drops_.size() < kMaxRateLimitBuckets) {
+          evicted_drops_.emplace(it->first, it->second.dropped);
+        } else {
+          untracked_drops_ += it->second.dropped;
+        }
+      }
+      it = buckets_.erase(it);
+    }
+  }
+
+ private:
+  struct Bucket {
+    double tokens;
+    std::chrono::steady_clock::time_point last;
+    uint64_t dropped;
+  };
+
+  static void AddSource(uint64_t key, uint64_t dropped, SessionMetrics* metrics) {
+    if (dropped == 0) {
+      return;
+    }
+    in_addr addr{};
+    addr.s_addr = static_cast<in_addr_t>(key >> 16);
+    char buffer[INET_ADDRSTRLEN] = {0};
+    RateLimitedSource source;
+    if (inet_ntop(AF_INET, &addr, buffer, sizeof(buffer)) != nullptr) {
+      source.source_ip = buffer;
+    }
+    source.device_number = static_cast<uint8_t>(key >> 8);
+    source.packet_type = static_cast<PacketType>(key & 0xff);
+    source.dropped = dropped;
+    metrics->rate_limited += dropped;
+    metrics->rate_limited_sources.push_back(std::move(source));
+  }
+
+  std::array<RateLimit, 256> limits_{};
+  std::array<bool, 256> limited_{};
+  mutable std::mutex mutex_;
+  std::unordered_map<uint64_t, Bucket> buckets_;
+  // Drop totals of evicted buckets, by bucket key.
+  std::unordered_map<uint64_t, uint64_t> evicted_drops_;
+  uint64_t untracked_drops_ = 0;
+};
+
+// Remembers recently received packets so a multi-interface session can drop
+// a copy that arrives on a second interface. Identical packets on the same
+// interface (repeated keep-alives) are never treated as duplicates.
+class DuplicateFilter {
+ public:
+  // Returns true if the same bytes arrived on another interface within
+  // kDuplicateWindow; otherwise records the packet.
+  bool IsDuplicate(const uint8_t* data, size_t length, uint8_t interface_index,
+                   std::chrono::steady_clock::time_point now) {
+    const uint64_t hash = Fnv1a(data, length);
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const Entry& entry : entries_) {
+      if (entry.hash == hash && entry.length == length &&
+          entry.interface_index != interface_index &&
+          now - entry.time <= kDuplicateWindow && entry.time - now <= kDuplicateWindow) {
+        ++dropped_;
+        return true;
+      }
+    }
+    entries_[next_] = Entry{hash, length, interface_index, now};
+    next_ = (next_ + 1) % entries_.size();
     return false;
   }
-  // Safe because we checked length >= kStatusMinimumSize.
-  out->device_name = ParseDeviceName(data, length);
-  out->device_number = data[kOffsetDeviceNumber];
-  const uint16_t raw_bpm = ReadBe16(data, kOffsetStatusBpm);
-  if (raw_bpm == kMaxUint16) {
-    out->bpm.reset();
-  } else {
-    out->bpm = raw_bpm;
+
+  uint64_t dropped() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return dropped_;
   }
-  const uint32_t raw_beat = ReadBe32(data, kOffsetStatusBeat);
-  if (raw_beat == kMaxUint32) {
-    out->beat.reset();
-  } else {
-    out->beat = raw_beat;
+
+ private:
+  struct Entry {
+    uint64_t hash = 0;
+    size_t length = 0;
+    uint8_t interface_index = 0;
+    std::chrono::steady_clock::time_point time{};
+  };
+
+  static uint64_t Fnv1a(const uint8_t* data, size_t length) {
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (size_t i = 0; i < length; ++i) {
+      hash = (hash ^ data[i]) * 0x100000001b3ull;
+    }
+    return hash;
+  }
+
+  mutable std::mutex mutex_;
+  std::array<Entry, kDuplicateHistory> entries_{};
+  size_t next_ = 0;
+  uint64_t dropped_ = 0;
+};
+
+// Latest precise position per device number behind a per-slot sequence
+// lock, so render threads can poll without blocking the receive path. The
+// sequence is odd while a writer is inside; readers retry until they see the
+// same even value before and after copying the fields.
+class PositionSlots {
+ public:
+  void Store(const PositionInfo& info) {
+    Slot& slot = slots_[info.device_number];
+    uint32_t sequence = slot.sequence.load(std::memory_order_relaxed);
+    do {
+      while ((sequence & 1) != 0) {
+        sequence = slot.sequence.load(std::memory_order_relaxed);
+      }
+    } while (!slot.sequence.compare_exchange_weak(sequence, sequence + 1,
+                                                  std::memory_order_acquire,
+                                                  std::memory_order_relaxed));
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.track_length_s.store(info.track_length_s, std::memory_order_relaxed);
+    slot.playhead_ms.store(info.playhead_ms, std::memory_order_relaxed);
+    slot.pitch.store(info.pitch, std::memory_order_relaxed);
+    slot.bpm.store(info.bpm, std::memory_order_relaxed);
+    slot.receive_time_ns.store(info.receive_time.time_since_epoch().count(),
+                               std::memory_order_relaxed);
+    slot.interface_index.store(info.interface_index, std::memory_order_relaxed);
+    slot.sequence.store(sequence + 2, std::memory_order_release);
+  }
+
+  std::optional<PositionInfo> Load(uint8_t device_number) const {
+    const Slot& slot = slots_[device_number];
+    PositionInfo info;
+    info.device_number = device_number;
+    while (true) {
+      const uint32_t before = slot.sequence.load(std::memory_order_acquire);
+      if (before == 0) {
+        return std::nullopt;
+      }
+      if ((before & 1) != 0) {
+        continue;
+      }
+      info.track_length_s = slot.track_length_s.load(std::memory_order_relaxed);
+      info.playhead_ms = slot.playhead_ms.load(std::memory_order_relaxed);
+      info.pitch = slot.pitch.load(std::memory_order_relaxed);
+      info.bpm = slot.bpm.load(std::memory_order_relaxed);
+      info.receive_time = std::chrono::steady_clock::time_point(
+          std::chrono::steady_clock::duration(
+              slot.receive_time_ns.load(std::memory_order_relaxed)));
+      info.interface_index = slot.interface_index.load(std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (slot.sequence.load(std::memory_order_relaxed) == before) {
+        return info;
+      }
+    }
+  }
+
+ private:
+  struct Slot {
+    std::atomic<uint32_t> sequence{0};
+    std::atomic<uint32_t> track_length_s{0};
+    std::atomic<uint32_t> playhead_ms{0};
+    std::atomic<int32_t> pitch{0};
+    std::atomic<uint32_t> bpm{0};
+    std::atomic<std::chrono::steady_clock::rep> receive_time_ns{0};
+    std::atomic<uint8_t> interface_index{0};
+  };
+
+  std::array<Slot, 256> slots_{};
+};
+
+// On-air and fader start state per mixer channel. The on-air flags are one
+// bitset word and each fader start command its own byte, so IsOnAir() and
+// GetFaderStart() are single atomic loads.
+class MixerChannelTable {
+ public:
+  void SetOnAir(const OnAirInfo& info) {
+    uint32_t bits = kOnAirReported;
+    for (size_t i = 0; i < kMixerChannelCount; ++i) {
+      bits |= info.on_air[i] ? 1u << i : 0u;
+    }
+    on_air_.store(bits, std::memory_order_release);
+  }
+
+  std::optional<bool> IsOnAir(uint8_t channel) const {
+    const uint32_t bits = on_air_.load(std::memory_order_acquire);
+    if (channel < 1 || channel > kMixerChannelCount || (bits & kOnAirReported) == 0) {
+      return std::nullopt;
+    }
+    return (bits & (1u << (channel - 1))) != 0;
+  }
+
+  // Channels marked kNoChange keep their previous command.
+  void SetFaderStart(const FaderStartInfo& info) {
+    for (size_t i = 0; i < kMixerChannelCount; ++i) {
+      if (info.commands[i] != FaderStartCommand::kNoChange) {
+        fader_start_[i].store(static_cast<uint8_t>(info.commands[i]),
+                              std::memory_order_release);
+      }
+    }
+  }
+
+  std::optional<FaderStartCommand> GetFaderStart(uint8_t channel) const {
+    if (channel < 1 || channel > kMixerChannelCount) {
+      return std::nullopt;
+    }
+    const uint8_t command = fader_start_[channel - 1].load(std::memory_order_acquire);
+    if (command == kNoFaderStart) {
+      return std::nullopt;
+    }
+    return static_cast<FaderStartCommand>(command);
+  }
+
+ private:
+  static constexpr uint32_t kOnAirReported = 1u << 31;
+  static constexpr uint8_t kNoFaderStart = 0xff;
+
+  std::atomic<uint32_t> on_air_{0};
+  std::array<std::atomic<uint8_t>, kMixerChannelCount> fader_start_ = {
+      {{kNoFaderStart}, {kNoFaderStart}, {kNoFaderStart}, {kNoFaderStart}}};
+};
+
+// Unicast destinations for control packets, indexed by device number.
+// Writers hold devices_mutex_; senders read without a lock. Each entry packs
+// the device's IPv4 address and interface index into one atomic word, and
+// keeps the interface that first reported the address. With
+// Config::connect_control_sockets a device number also owns a UDP socket
+// connect()ed to its address. The socket outlives device expiry and is reused
+// when the device comes back at the same address; one replaced by an address
+// change is closed once no send is using it.
+class DestinationCache {
+ public:
+  struct Destination {
+    sockaddr_in addr{};
+    uint8_t interface_index = 0;
+  };
+
+  DestinationCache() {
+    for (auto& fd : connected_) {
+      fd.store(-1, std::memory_order_relaxed);
+    }
+  }
+
+  ~DestinationCache() {
+    for (auto& fd : connected_) {
+      if (fd.load() >= 0) {
+        ::close(fd.load());
+      }
+    }
+    for (const RetiredSocket& retired : retired_) {
+      ::close(retired.fd);
+    }
+  }
+
+  DestinationCache(const DestinationCache&) = delete;
+  DestinationCache& operator=(const DestinationCache&) = delete;
+
+  // Record a device's address and the interface it was seen on. `source_ip`
+  // is that interface's bind address; when `connect` is set, a connected
+  // socket is opened from it unless the device already has one for the same
+  // source and destination addresses.
+  void Update(uint8_t device_number, uint32_t ip, uint8_t interface_index, bool connect,
+              uint32_t source_ip) {
+    if (ip == 0) {
+      return;
+    }
+    if (connect) {
+      const uint64_t route = (uint64_t{source_ip} << 32) | ip;
+      if (connected_route_[device_number] != route) {
+        const int fd = ConnectSocket(source_ip, ip);
+        connected_route_[device_number] = fd >= 0 ? route : 0;
+        Replace(device_number, fd);
+      }
+    }
+    const uint64_t entry = kValid | (uint64_t{interface_index} << 32) | ip;
+    if (entries_[device_number].load(std::memory_order_relaxed) != entry) {
+      entries_[device_number].store(entry, std::memory_order_release);
+    }
   }
-  out->pitch = ReadBe24(data, kOffsetStatusPitch);
-  out->beat_within_bar = data[kOffsetStatusBeatWithinBar];
-  // Sanitize beat_within_bar to valid range (1-8, common values are 1-4)
-  if (out->beat_within_bar < 1 || out->beat_within_bar > 8) {
-    out->beat_within_bar = 1;
+
+  // Forget an expired device's address; its connected socket is kept.
+  void Clear(uint8_t device_number) {
+    entries_[device_number].store(0, std::memory_order_release);
+  }
+
+  bool Load(uint8_t device_number, Destination* out) const {
+    const uint64_t entry = entries_[device_number].load(std::memory_order_acquire);
+    if ((entry & kValid) == 0) {
+      return false;
+    }
+    out->addr = Ipv4Sockaddr(static_cast<uint32_t>(entry), kBeatPort);
+    out->interface_index = static_cast<uint8_t>(entry >> 32);
+    return true;
+  }
+
+  // Send on the device's connected socket. Returns false if it has none;
+  // otherwise `*result` is the send() result.
+  bool SendConnected(uint8_t device_number, const uint8_t* data, size_t size,
+                     ssize_t* result) {
+    // Sequentially consistent so Replace() either sees this sender or this
+    // sender sees the replacement socket.
+    senders_[device_number].fetch_add(1);
+    const int fd = connected_[device_number].load();
+    if (fd >= 0) {
+      *result = ::send(fd, data, size, 0);
+    }
+    senders_[device_number].fetch_sub(1);
+    return fd >= 0;
+  }
+
+ private:
+  static constexpr uint64_t kValid = uint64_t{1} << 40;
+
+  struct RetiredSocket {
+    uint8_t device_number;
+    int fd;
+  };
+
+  // UDP socket bound to `source_ip` (any address if 0) on an ephemeral port,
+  // so it never takes datagrams meant for the listening sockets, and
+  // connected to the device's port 50001. Returns -1 on failure.
+  static int ConnectSocket(uint32_t source_ip, uint32_t ip) {
+    const int fd = ::socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd < 0) {
+      return -1;
+    }
+    const sockaddr_in source = Ipv4Sockaddr(source_ip, 0);
+    const sockaddr_in dest = Ipv4Sockaddr(ip, kBeatPort);
+    if (::bind(fd, reinterpret_cast<const sockaddr*>(&source), sizeof(source)) < 0 ||
+        ::connect(fd, reinterpret_cast<const sockaddr*>(&dest), sizeof(dest)) < 0) {
+      ::close(fd);
+      return -1;
+    }
+    return fd;
   }
-  if (length > kOffsetStatusMasterHandoff) {
-    out->master_handoff_to = data[kOffsetStatusMasterHandoff];
-  } else {
-    out->master_handoff_to = 0xff;
+
+  // Swap in a device's new socket and close replaced sockets that no sender
+  // still holds; the rest are retried on the next replacement.
+  void Replace(uint8_t device_number, int fd) {
+    const int old_fd = connected_[device_number].exchange(fd);
+    if (old_fd >= 0) {
+      retired_.push_back({device_number, old_fd});
+    }
+    auto idle = [this](const RetiredSocket& retired) {
+      if (senders_[retired.device_number].load() != 0) {
+        return false;
+      }
+      ::close(retired.fd);
+      return true;
+    };
+    retired_.erase(std::remove_if(retired_.begin(), retired_.end(), idle), retired_.end());
   }
-  const uint8_t flags = data[kOffsetStatusFlags];
-  out->is_master = (flags & kStatusFlagMaster) != 0;
-  out->is_synced = (flags & kStatusFlagSynced) != 0;
-  out->is_playing = (flags & kStatusFlagPlaying) != 0;
-  return true;
-}
 
-// Convert pitch value to a multiplier (1.0 at neutral pitch).
-double PitchToMultiplier(uint32_t pitch) {
-  return pitch / static_cast<double>(kNeutralPitch);
-}
+  std::array<std::atomic<uint64_t>, 256> entries_{};
+  std::array<std::atomic<int>, 256> connected_;
+  std::array<std::atomic<uint32_t>, 256> senders_{};
+  // Source and destination address each connected socket was opened for
+  // (source << 32 | destination, 0 if none); writer-only.
+  std::array<uint64_t, 256> connected_route_{};
+  std::vector<RetiredSocket> retired_;
+};
 
-// Convert percent (-100..+100) into raw pitch value.
-uint32_t PitchFromPercent(double percent) {
-  return static_cast<uint32_t>(
-      std::lround(percent * kNeutralPitch / 100.0) + kNeutralPitch);
-}
+// Per-datagram metadata captured by the receive path. The source address is
+// kept raw (network byte order, 0 for replayed packets) and only formatted
+// when a device snapshot is handed to the user.
+struct PacketMeta {
+  uint32_t source_ip = 0;
+  std::chrono::steady_clock::time_point receive_time;
+  uint8_t interface_index = 0;
+};
 
-// Beat payload template based on observed packets (see Analysis.tex beat packet layout).
-// Fields at offsets documented above are overwritten before sending.
-const std::vector<uint8_t>& BeatPayloadTemplate() {
-  static const std::vector<uint8_t> payload = {
-      0x01, 0x00, 0x0d, 0x00, 0x3c, 0x01, 0x01, 0x01, 0x01, 0x02, 0x02, 0x02,
-      0x02, 0x10, 0x10, 0x10, 0x10, 0x04, 0x04, 0x04, 0x04, 0x20, 0x20, 0x20,
-      0x20, 0x08, 0x08, 0x08, 0x08, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
-      0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
-      0xff, 0xff, 0xff, 0xff, 0x00, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-      0x0b, 0x00, 0x00, 0x0d, 0x00};
-  return payload;
-}
-
-// Status payload template based on observed CDJ status packets (see Analysis.tex).
-// Fields at offsets documented above are overwritten before sending.
-const std::vector<uint8_t>& StatusPayloadTemplate() {
-  static const std::vector<uint8_t> payload = {
-      0x01, 0x04, 0x00, 0x00, 0xf8, 0x00, 0x00, 0x01, 0x00, 0x00, 0x03, 0x01,
-      0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00,
-      0x00, 0x00, 0x00, 0xa0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-      0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x04, 0x04, 0x00, 0x00, 0x00, 0x04,
-      0x00, 0x00, 0x00, 0x04, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-      0x31, 0x2e, 0x34, 0x33, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-      0x00, 0x00, 0xff, 0x00, 0x00, 0x10, 0x00, 0x00, 0x80, 0x00, 0x00, 0x00,
-      0x7f, 0xff, 0xff, 0xff, 0x00, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-      0x00, 0x00, 0x00, 0x00, 0x01, 0xff, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00,
-      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00,
-      0x00, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0f, 0x01, 0x00, 0x00,
-      0x12, 0x34, 0x56, 0x78, 0x00, 0x00, 0x00, 0x01, 0x01, 0x01, 0x01, 0x01,
-      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-      0x00, 0x00, 0x00, 0x15, 0x00, 0x00, 0x07, 0x61, 0x00, 0x00, 0x06, 0x2f};
-  return payload;
+KeepAliveInfo KeepAliveFromView(const KeepAliveView& view) {
+  KeepAliveInfo info;
+  info.device_name = view.device_name();
+  info.device_number = view.device_number();
+  info.device_type = view.device_type();
+  info.mac_address = view.mac_address();
+  info.ip_address = view.ip_address();
+  return info;
 }
 
-struct KeepAliveInfo {
-  uint8_t device_number = 0;
-  uint8_t device_type = 0;
-  std::string device_name;
-  std::string ip_address;
-  std::array<uint8_t, 6> mac_address = {0, 0, 0, 0, 0, 0};
-};
-
 // Parse a keep-alive packet (type 0x06) from port 50000.
 bool ParseKeepAlive(const uint8_t* data, size_t length, KeepAliveInfo* out) {
-  if (!out || length < kKeepAlivePacketSize || !HasHeader(data, length)) {
+  const KeepAliveView view(data, length);
+  if (!out || !view.valid()) {
     return false;
   }
-  if (data[kPacketTypeOffset] != static_cast<uint8_t>(PacketType::kDeviceKeepAlive)) {
-    return false;
-  }
-  out->device_name = ParseDeviceName(data, length);
-  if (out->device_name.empty()) {
-    out->device_name = ParseDeviceNameAt(data, length, kDeviceNameOffset + 1);
-  }
-  out->device_number = data[kOffsetKeepAliveDeviceNumber];
-  out->device_type = data[kOffsetKeepAliveDeviceType];
-  std::memcpy(out->mac_address.data(), data + kOffsetKeepAliveMac, out->mac_address.size());
-
-  char ip_buffer[INET_ADDRSTRLEN] = {0};
-  in_addr addr{};
-  std::memcpy(&addr, data + kOffsetKeepAliveIp, sizeof(addr));
-  if (inet_ntop(AF_INET, &addr, ip_buffer, sizeof(ip_buffer)) != nullptr) {
-    out->ip_address = ip_buffer;
-  }
+  *out = KeepAliveFromView(view);
   return true;
 }
 
-std::string AddrToString(const sockaddr_in& addr) {
-  char buffer[INET_ADDRSTRLEN] = {0};
-  if (inet_ntop(AF_INET, &addr.sin_addr, buffer, sizeof(buffer)) != nullptr) {
-    return buffer;
-  }
-  return {};
-}
-
 void LogError(const std::string& message, const Config* config) {
   if (config && config->log_callback) {
     config->log_callback(message);
@@ -627,6 +2134,45 @@ bool Config::Validate(std::string* error) const {
   if (status_interval_ms <= 0 || announce_interval_ms <= 0 || beats_per_bar <= 0) {
     return fail("intervals and beats_per_bar must be positive");
   }
+  if (recv_batch_size <= 0 || recv_batch_size > kMaxRecvBatchSize) {
+    return fail("recv_batch_size must be between 1 and 1024");
+  }
+  if (recv_buffer_bytes < 0) {
+    return fail("recv_buffer_bytes must be >= 0");
+  }
+  if (send_buffer_bytes < 0) {
+    return fail("send_buffer_bytes must be >= 0");
+  }
+  if (!parse_packets && follow_master) {
+    return fail("follow_master requires parse_packets");
+  }
+  if (busy_poll_us < 0) {
+    return fail("busy_poll_us must be >= 0");
+  }
+  for (const auto& entry : rate_limits) {
+    if (entry.first == PacketType::kBeat) {
+      return fail("rate_limits must not include beats");
+    }
+    if (!(entry.second.packets_per_second > 0.0) || !(entry.second.burst >= 1.0)) {
+      return fail("rate_limits need packets_per_second > 0 and burst >= 1");
+    }
+  }
+  if (beat_lane_priority < 0 || beat_lane_priority > 99) {
+    return fail("beat_lane_priority must be between 0 and 99");
+  }
+  if (beat_lane && recv_backend == RecvBackend::kIoUring) {
+    return fail("beat_lane is not supported with recv_backend kIoUring");
+  }
+#ifndef __linux__
+  if (recv_backend == RecvBackend::kEpoll) {
+    return fail("recv_backend kEpoll requires Linux");
+  }
+#endif
+#ifndef PROLINK_HAVE_IO_URING
+  if (recv_backend == RecvBackend::kIoUring) {
+    return fail("recv_backend kIoUring requires building with PROLINK_ENABLE_IO_URING");
+  }
+#endif
   if (device_timeout.count() <= 0 || device_prune_interval.count() <= 0) {
     return fail("device timeouts must be positive");
   }
@@ -654,9 +2200,56 @@ bool Config::Validate(std::string* error) const {
   if (!announce_address.empty() && !is_valid_ipv4(announce_address)) {
     return fail("announce_address must be a valid IPv4 address");
   }
+  if (network_interface.find('/') != std::string::npos) {
+    uint32_t network = 0;
+    uint32_t mask = 0;
+    if (!ParseSubnet(network_interface, &network, &mask)) {
+      return fail("network_interface subnet must look like 192.168.1.0/24");
+    }
+  }
+  if (interfaces.size() > kMaxInterfaces) {
+    return fail("interfaces supports at most 8 entries");
+  }
+  for (size_t i = 0; i < interfaces.size(); ++i) {
+    const InterfaceConfig& iface = interfaces[i];
+#ifndef __linux__
+    if (!iface.name.empty()) {
+      return fail("interfaces[].name requires Linux");
+    }
+#endif
+    if (!is_valid_ipv4(iface.bind_address)) {
+      return fail("interfaces[].bind_address must be a valid IPv4 address");
+    }
+    if (!is_valid_ipv4(iface.broadcast_address)) {
+      return fail("interfaces[].broadcast_address must be a valid IPv4 address");
+    }
+    if (!iface.announce_address.empty() && !is_valid_ipv4(iface.announce_address)) {
+      return fail("interfaces[].announce_address must be a valid IPv4 address");
+    }
+    if (!iface.device_ip.empty() && !is_valid_ipv4(iface.device_ip)) {
+      return fail("interfaces[].device_ip must be a valid IPv4 address");
+    }
+    for (size_t j = 0; j < i; ++j) {
+      if (interfaces[j].name == iface.name &&
+          interfaces[j].bind_address == iface.bind_address) {
+        return fail("interfaces must not repeat the same name and bind_address");
+      }
+    }
+  }
   if (!capture_file.empty() && !replay_file.empty()) {
     return fail("capture_file and replay_file are mutually exclusive");
   }
+  if (!monitor_interface.empty()) {
+#ifndef __linux__
+    return fail("monitor_interface requires Linux");
+#endif
+    if (!replay_file.empty()) {
+      return fail("monitor_interface and replay_file are mutually exclusive");
+    }
+    if (recv_backend == RecvBackend::kIoUring || recv_backend == RecvBackend::kBusyPoll) {
+      return fail("monitor_interface is not supported with recv_backend kIoUring or kBusyPoll");
+    }
+  }
   return true;
 }
 
@@ -664,6 +2257,20 @@ double BeatInfo::effective_bpm() const {
   return bpm * PitchToMultiplier(pitch) / 100.0;
 }
 
+double SessionMetrics::average_packets_per_wakeup() const {
+  if (receive_wakeups == 0) {
+    return 0.0;
+  }
+  return static_cast<double>(datagrams_received) / receive_wakeups;
+}
+
+double LatencyMetrics::average_us() const {
+  if (count == 0) {
+    return 0.0;
+  }
+  return static_cast<double>(total_ns) / static_cast<double>(count) / 1000.0;
+}
+
 std::optional<double> StatusInfo::effective_bpm() const {
   if (!bpm.has_value()) {
     return std::nullopt;
@@ -671,12 +2278,123 @@ std::optional<double> StatusInfo::effective_bpm() const {
   return bpm.value() * PitchToMultiplier(pitch) / 100.0;
 }
 
+BeatInfo Materialize(const BeatView& view) {
+  BeatInfo info;
+  info.device_number = view.device_number();
+  info.device_name = std::string(view.device_name());
+  info.bpm = view.bpm();
+  info.pitch = view.pitch();
+  info.beat_within_bar = view.beat_within_bar();
+  info.next_beat_ms = view.next_beat_ms();
+  info.next_bar_ms = view.next_bar_ms();
+  info.receive_time = view.receive_time();
+  info.interface_index = view.interface_index();
+  return info;
+}
+
+StatusInfo Materialize(const StatusView& view, uint32_t fields) {
+  StatusInfo info;
+  info.device_number = view.device_number();
+  info.device_name = std::string(view.device_name());
+  info.bpm = view.bpm();
+  info.pitch = view.pitch();
+  info.beat = view.beat();
+  info.beat_within_bar = view.beat_within_bar();
+  info.master_handoff_to = view.master_handoff_to();
+  info.is_master = view.is_master();
+  info.is_synced = view.is_synced();
+  info.is_playing = view.is_playing();
+  info.receive_time = view.receive_time();
+  info.interface_index = view.interface_index();
+  info.fields = fields & kStatusFieldsAll;
+  if ((fields & kStatusFieldTrack) != 0) {
+    info.track_source_player = view.track_source_player();
+    info.track_source_slot = view.track_source_slot();
+    info.track_type = view.track_type();
+    info.rekordbox_id = view.rekordbox_id();
+    info.track_number = view.track_number();
+  }
+  if ((fields & kStatusFieldPlayState) != 0) {
+    info.play_state = view.play_state();
+    info.play_state2 = view.play_state2();
+    info.play_state3 = view.play_state3();
+    info.is_on_air = view.is_on_air();
+    info.is_bpm_synced = view.is_bpm_synced();
+  }
+  if ((fields & kStatusFieldCounters) != 0) {
+    info.firmware_version = std::string(view.firmware_version());
+    info.sync_counter = view.sync_counter();
+    info.beats_until_cue = view.beats_until_cue();
+    info.packet_counter = view.packet_counter();
+  }
+  return info;
+}
+
+MixerStatusInfo Materialize(const MixerStatusView& view) {
+  MixerStatusInfo info;
+  info.device_number = view.device_number();
+  info.device_name = std::string(view.device_name());
+  info.bpm = view.bpm();
+  info.pitch = view.pitch();
+  info.beat_within_bar = view.beat_within_bar();
+  info.master_handoff_to = view.master_handoff_to();
+  info.is_master = view.is_master();
+  info.receive_time = view.receive_time();
+  info.interface_index = view.interface_index();
+  return info;
+}
+
+DeviceInfo Materialize(const KeepAliveView& view) {
+  DeviceInfo info;
+  info.device_number = view.device_number();
+  info.device_type = view.device_type();
+  info.device_name = std::string(view.device_name());
+  info.ip_address = Ipv4ToString(view.ip_address());
+  info.mac_address = view.mac_address();
+  info.receive_time = view.receive_time();
+  info.interface_index = view.interface_index();
+  return info;
+}
+
+struct LatencyMetricsAtomic {
+  std::atomic<uint64_t> count{0};
+  std::atomic<uint64_t> total_ns{0};
+  std::atomic<uint64_t> max_ns{0};
+
+  void Record(std::chrono::steady_clock::time_point since) {
+    const auto elapsed = std::chrono::steady_clock::now() - since;
+    const uint64_t ns = static_cast<uint64_t>(std::max<int64_t>(
+        0, std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+    count.fetch_add(1);
+    total_ns.fetch_add(ns);
+    uint64_t current = max_ns.load();
+    while (ns > current && !max_ns.compare_exchange_weak(current, ns)) {
+    }
+  }
+
+  LatencyMetrics Snapshot() const {
+    LatencyMetrics snapshot;
+    snapshot.count = count.load();
+    snapshot.total_ns = total_ns.load();
+    snapshot.max_ns = max_ns.load();
+    return snapshot;
+  }
+};
+
 struct SessionMetricsAtomic {
   std::atomic<uint64_t> packets_received{0};
   std::atomic<uint64_t> packets_sent{0};
   std::atomic<uint64_t> parse_errors{0};
   std::atomic<uint64_t> send_errors{0};
   std::atomic<uint64_t> callback_exceptions{0};
+  std::atomic<uint64_t> datagrams_received{0};
+  std::atomic<uint64_t> receive_wakeups{0};
+  std::atomic<uint64_t> userspace_rejected{0};
+  std::atomic<uint64_t> kernel_drops_closed{0};
+  std::atomic<uint64_t> broadcast_fallbacks{0};
+  LatencyMetricsAtomic beat_latency;
+  LatencyMetricsAtomic status_latency;
+  std::array<std::atomic<uint64_t>, 256> truncated_by_type{};
 
   SessionMetrics Snapshot() const {
     SessionMetrics snapshot;
@@ -685,6 +2403,20 @@ struct SessionMetricsAtomic {
     snapshot.parse_errors = parse_errors.load();
     snapshot.send_errors = send_errors.load();
     snapshot.callback_exceptions = callback_exceptions.load();
+    snapshot.datagrams_received = datagrams_received.load();
+    snapshot.receive_wakeups = receive_wakeups.load();
+    snapshot.userspace_rejected = userspace_rejected.load();
+    snapshot.kernel_drops = kernel_drops_closed.load();
+    snapshot.broadcast_fallbacks = broadcast_fallbacks.load();
+    snapshot.beat_latency = beat_latency.Snapshot();
+    snapshot.status_latency = status_latency.Snapshot();
+    for (size_t type = 0; type < truncated_by_type.size(); ++type) {
+      const uint64_t count = truncated_by_type[type].load();
+      if (count != 0) {
+        snapshot.truncated_by_type[static_cast<uint8_t>(type)] = count;
+        snapshot.truncated_packets += count;
+      }
+    }
     return snapshot;
   }
 };
@@ -707,6 +2439,7 @@ struct Session::Impl {
 
   explicit Impl(Config config)
       : config_(std::move(config)),
+        rate_limiter_(config_.rate_limits),
         clock_(config_.beats_per_bar) {
     state_.tempo_bpm = config_.tempo_bpm;
     state_.pitch = PitchFromPercent(config_.pitch_percent);
@@ -715,9 +2448,34 @@ struct Session::Impl {
     state_.synced = config_.synced;
     clock_.SetTempo(state_.tempo_bpm);
     clock_.SetPlaying(state_.playing);
+    const bool unset_mac = config_.mac_address == std::array<uint8_t, 6>{};
+    for (const InterfaceConfig& iface_config : ResolveInterfaces(config_)) {
+      auto iface = std::make_unique<NetInterface>();
+      iface->config = iface_config;
+      iface->bind_ip = MakeSockaddr(iface_config.bind_address, 0).sin_addr.s_addr;
+      iface->broadcast_ip = MakeSockaddr(iface_config.broadcast_address, 0).sin_addr.s_addr;
+      iface->announce_ip = MakeSockaddr(iface_config.announce_address, 0).sin_addr.s_addr;
+      iface->device_ip = iface_config.device_ip;
+      iface->mac_address = config_.mac_address;
+      if (config_.auto_network) {
+        const InterfaceConfig defaults;
+        iface->auto_ip = iface_config.device_ip.empty();
+        iface->auto_mac = unset_mac;
+        iface->auto_broadcast = iface_config.broadcast_address == defaults.broadcast_address;
+        iface->auto_announce = iface_config.announce_address == defaults.broadcast_address;
+      }
+      EncodeKeepAliveLocked(*iface);
+      interfaces_.push_back(std::move(iface));
+    }
+    EncodeSendBuffers();
   }
 
   bool Start() {
+    if (running_) {
+      return true;
+    }
+    // A replay that ran out cleared running_ itself; join that run first.
+    Stop();
     if (running_.exchange(true)) {
       return true;
     }
@@ -738,6 +2496,12 @@ struct Session::Impl {
         running_ = false;
         return false;
       }
+      if (!ReadReplayHeader()) {
+        LogError(start_error_, &config_);
+        running_ = false;
+        replay_stream_.close();
+        return false;
+      }
     }
     if (!config_.capture_file.empty()) {
       capture_stream_.open(config_.capture_file,
@@ -749,51 +2513,52 @@ struct Session::Impl {
         replay_stream_.close();
         return false;
       }
+      capture_stream_.write(kCaptureMagic, sizeof(kCaptureMagic));
+      capture_stream_.write(reinterpret_cast<const char*>(&kCaptureVersion),
+                            sizeof(kCaptureVersion));
     }
-    const uint16_t beat_port = replay_mode_ ? 0 : kBeatPort;
-    const uint16_t status_port = replay_mode_ ? 0 : kStatusPort;
-    if (!beat_socket_.Open(beat_port, config_.bind_address, true)) {
-      start_error_ = beat_socket_.last_error();
+    if (config_.auto_network && !ResolveNetwork(true)) {
       LogError(start_error_, &config_);
       running_ = false;
       capture_stream_.close();
       replay_stream_.close();
       return false;
     }
-    if (!status_socket_.Open(status_port, config_.bind_address, true)) {
-      start_error_ = status_socket_.last_error();
+    monitor_mode_ = !config_.monitor_interface.empty();
+    // Replay and monitor modes only use the UDP sockets for sending.
+    const bool passive_receive = replay_mode_ || monitor_mode_;
+    if (!OpenSockets(passive_receive)) {
       LogError(start_error_, &config_);
-      beat_socket_.Close();
       running_ = false;
       capture_stream_.close();
       replay_stream_.close();
       return false;
     }
-    if (!replay_mode_) {
-      if (!device_socket_.Open(kAnnouncePort, config_.bind_address, true)) {
-        start_error_ = device_socket_.last_error();
-        LogError(start_error_, &config_);
-        status_socket_.Close();
-        beat_socket_.Close();
-        running_ = false;
-        capture_stream_.close();
-        replay_stream_.close();
-        return false;
-      }
+    if (config_.kernel_filter && !passive_receive && !AttachKernelFilters()) {
+      LogError(start_error_, &config_);
+      CloseSockets();
+      running_ = false;
+      capture_stream_.close();
+      replay_stream_.close();
+      return false;
     }
-    if (!announce_socket_.Open(0, config_.bind_address, true)) {
-      start_error_ = announce_socket_.last_error();
+    if (!replay_mode_ && !OpenRecvReactor()) {
       LogError(start_error_, &config_);
-      device_socket_.Close();
-      status_socket_.Close();
-      beat_socket_.Close();
+      recv_lane_.reactor.Close();
+      beat_lane_.reactor.Close();
+      CloseSockets();
       running_ = false;
       capture_stream_.close();
       replay_stream_.close();
       return false;
     }
+    started_ = true;
     try {
-      recv_thread_ = std::thread([this]() { RecvLoop(); });
+      recv_lane_.thread = std::thread([this]() { RecvLoop(recv_lane_); });
+      if (!beat_lane_.sockets.empty()) {
+        beat_lane_.thread = std::thread([this]() { RecvLoop(beat_lane_); });
+        SetBeatLanePriority();
+      }
       beat_thread_ = std::thread([this]() { BeatLoop(); });
       status_thread_ = std::thread([this]() { StatusLoop(); });
       if (config_.send_announces) {
@@ -817,17 +2582,29 @@ struct Session::Impl {
   }
 
   void Stop() {
-    if (!running_.exchange(false)) {
+    running_ = false;
+    if (!started_.exchange(false)) {
       return;
     }
     state_cv_.notify_all();
-    beat_socket_.Close();
-    status_socket_.Close();
-    device_socket_.Close();
-    announce_socket_.Close();
-    if (recv_thread_.joinable()) {
-      recv_thread_.join();
+    recv_lane_.reactor.Wake();
+    beat_lane_.reactor.Wake();
+#ifdef PROLINK_HAVE_IO_URING
+    if (io_uring_) {
+      io_uring_->Wake();
+    }
+#endif
+    CloseSockets();
+    for (RecvLane* lane : {&recv_lane_, &beat_lane_}) {
+      if (lane->thread.joinable()) {
+        lane->thread.join();
+      }
+      lane->reactor.Close();
+      lane->sockets.clear();
     }
+#ifdef __linux__
+    sniffer_.Close();
+#endif
     if (beat_thread_.joinable()) {
       beat_thread_.join();
     }
@@ -840,6 +2617,9 @@ struct Session::Impl {
     if (prune_thread_.joinable()) {
       prune_thread_.join();
     }
+#ifdef PROLINK_HAVE_IO_URING
+    io_uring_.reset();
+#endif
     {
       std::lock_guard<std::mutex> lock(capture_mutex_);
       if (capture_stream_.is_open()) {
@@ -855,9 +2635,10 @@ struct Session::Impl {
     std::lock_guard<std::mutex> lock(callback_mutex_);
     beat_cb_ = std::move(cb);
   }
-  void SetStatusCallback(StatusCallback cb) {
+  void SetStatusCallback(StatusCallback cb, uint32_t fields) {
     std::lock_guard<std::mutex> lock(callback_mutex_);
     status_cb_ = std::move(cb);
+    status_fields_ = fields;
   }
   void SetDeviceCallback(DeviceCallback cb) {
     std::lock_guard<std::mutex> lock(callback_mutex_);
@@ -868,6 +2649,47 @@ struct Session::Impl {
     device_event_cb_ = std::move(cb);
   }
 
+  void SetBeatViewCallback(BeatViewCallback cb) {
+    std::lock_guard<std::mutex> lock(callback_mutex_);
+    beat_view_cb_ = std::move(cb);
+  }
+
+  void SetStatusViewCallback(StatusViewCallback cb) {
+    std::lock_guard<std::mutex> lock(callback_mutex_);
+    status_view_cb_ = std::move(cb);
+  }
+
+  void SetKeepAliveViewCallback(KeepAliveViewCallback cb) {
+    std::lock_guard<std::mutex> lock(callback_mutex_);
+    keep_alive_view_cb_ = std::move(cb);
+  }
+
+  void SetPositionCallback(PositionCallback cb) {
+    std::lock_guard<std::mutex> lock(callback_mutex_);
+    position_cb_ = std::move(cb);
+  }
+
+  void SetMixerStatusCallback(MixerStatusCallback cb) {
+    std::lock_guard<std::mutex> lock(callback_mutex_);
+    mixer_status_cb_ = std::move(cb);
+  }
+
+  void SetOnAirCallback(OnAirCallback cb) {
+    std::lock_guard<std::mutex> lock(callback_mutex_);
+    on_air_cb_ = std::move(cb);
+  }
+
+  void SetFaderStartCallback(FaderStartCallback cb) {
+    std::lock_guard<std::mutex> lock(callback_mutex_);
+    fader_start_cb_ = std::move(cb);
+  }
+
+  void SetRawPacketCallback(RawPacketCallback cb) {
+    std::lock_guard<std::mutex> lock(callback_mutex_);
+    raw_packet_cb_ = std::move(cb);
+    raw_packet_cb_generation_.fetch_add(1, std::memory_order_release);
+  }
+
   void SetTempo(double bpm) {
     std::lock_guard<std::mutex> lock(state_mutex_);
     state_.tempo_bpm = bpm;
@@ -923,6 +2745,16 @@ struct Session::Impl {
     SendMasterHandoffRequestInternal(target_device);
   }
 
+  std::optional<PositionInfo> GetLatestPosition(uint8_t device_number) const {
+    return positions_.Load(device_number);
+  }
+
+  std::optional<bool> IsOnAir(uint8_t channel) const { return mixer_channels_.IsOnAir(channel); }
+
+  std::optional<FaderStartCommand> GetFaderStart(uint8_t channel) const {
+    return mixer_channels_.GetFaderStart(channel);
+  }
+
   std::optional<StatusInfo> GetTempoMaster() const {
     std::lock_guard<std::mutex> lock(state_mutex_);
     return master_status_;
@@ -934,7 +2766,7 @@ struct Session::Impl {
     result.reserve(devices_.size());
     for (const auto& entry : devices_) {
       if (entry.second.active) {
-        result.push_back(entry.second.info);
+        result.push_back(DeviceSnapshot(entry.second));
       }
     }
     return result;
@@ -944,16 +2776,121 @@ struct Session::Impl {
     return start_error_;
   }
 
+  std::vector<NetworkInterfaceInfo> GetInterfaces() const {
+    std::vector<NetworkInterfaceInfo> result;
+    std::lock_guard<std::mutex> lock(network_mutex_);
+    for (const auto& iface : interfaces_) {
+      NetworkInterfaceInfo info;
+      info.name = iface->host_name.empty() ? iface->config.name : iface->host_name;
+      info.device_ip = iface->device_ip;
+      info.mac_address = iface->mac_address;
+      info.broadcast_address = Ipv4ToString(iface->broadcast_ip.load());
+      info.announce_address = Ipv4ToString(iface->announce_ip.load());
+      result.push_back(std::move(info));
+    }
+    return result;
+  }
+
   SessionMetrics GetMetrics() const {
-    return metrics_.Snapshot();
+    // Stop() closes the sockets concurrently; see CloseSockets().
+    std::lock_guard<std::mutex> lock(sockets_mutex_);
+    SessionMetrics snapshot = metrics_.Snapshot();
+    snapshot.kernel_drops += LiveKernelDropsLocked();
+    rate_limiter_.Report(&snapshot);
+    snapshot.duplicates_dropped = duplicate_filter_.dropped();
+    if (running_ && !replay_mode_ && !monitor_mode_) {
+      for (const auto& iface : interfaces_) {
+        for (const UdpSocket* listener : iface->listeners()) {
+          SocketMetrics socket;
+          socket.port = listener->port();
+          socket.kernel_drops = listener->KernelDrops();
+          socket.queued_bytes = listener->QueuedBytes();
+          socket.recv_buffer_bytes = listener->RecvBufferBytes();
+          socket.interface_index = listener->interface_index();
+          snapshot.sockets.push_back(socket);
+        }
+      }
+    }
+#ifdef __linux__
+    snapshot.monitor_drops = sniffer_.Drops();
+#endif
+    return snapshot;
   }
 
  private:
+  // info.ip_address stays empty here; the raw address is formatted by
+  // DeviceSnapshot() only when a copy leaves the session.
   struct DeviceRecord {
     DeviceInfo info;
+    uint32_t ip_address = 0;
     bool active = false;
   };
 
+  static DeviceInfo DeviceSnapshot(const DeviceRecord& record) {
+    DeviceInfo info = record.info;
+    if (record.ip_address != 0) {
+      info.ip_address = Ipv4ToString(record.ip_address);
+    }
+    return info;
+  }
+
+  // Sockets and send addresses of one configured interface. The announce
+  // socket is send-only; the rest listen on the well-known ports. With
+  // Config::auto_network the addresses can change while running: the
+  // broadcast destinations are atomics, the announced identity and its
+  // encoded keep-alive are guarded by network_mutex_.
+  struct NetInterface {
+    InterfaceConfig config;
+    // Bind address in network byte order (0 for any).
+    uint32_t bind_ip = 0;
+    std::atomic<uint32_t> broadcast_ip{0};
+    std::atomic<uint32_t> announce_ip{0};
+    std::string host_name;
+    std::string device_ip;
+    std::array<uint8_t, 6> mac_address = {0, 0, 0, 0, 0, 0};
+    // Keep-alive for device_ip and mac_address; empty while there is no IP.
+    std::array<uint8_t, kMaxEncodedPacketSize> keep_alive{};
+    size_t keep_alive_size = 0;
+    // Fields auto_network resolves because they were left at their defaults.
+    bool auto_ip = false;
+    bool auto_mac = false;
+    bool auto_broadcast = false;
+    bool auto_announce = false;
+    UdpSocket beat_socket;
+    UdpSocket status_socket;
+    UdpSocket device_socket;
+    UdpSocket announce_socket;
+
+    std::array<UdpSocket*, 3> listeners() {
+      return {&beat_socket, &status_socket, &device_socket};
+    }
+    std::array<const UdpSocket*, 3> listeners() const {
+      return {&beat_socket, &status_socket, &device_socket};
+    }
+    sockaddr_in broadcast_addr(uint16_t port) const {
+      return Ipv4Sockaddr(broadcast_ip.load(std::memory_order_relaxed), port);
+    }
+    sockaddr_in announce_addr() const {
+      return Ipv4Sockaddr(announce_ip.load(std::memory_order_relaxed), kAnnouncePort);
+    }
+  };
+
+  // An outgoing packet encoded once when the session is created. Senders
+  // patch the fields that change under `mutex` and send straight from
+  // `data`, so the send path does not allocate.
+  struct SendBuffer {
+    std::mutex mutex;
+    std::array<uint8_t, kMaxEncodedPacketSize> data{};
+    size_t size = 0;
+  };
+
+  // A receive thread and the sockets it serves.
+  struct RecvLane {
+    RecvReactor reactor;
+    std::vector<UdpSocket*> sockets;
+    std::thread thread;
+  };
+
   struct State {
     double tempo_bpm = 120.0;
     uint32_t pitch = kNeutralPitch;
@@ -980,30 +2917,139 @@ struct Session::Impl {
 
   void RecordParseError() {
     metrics_.parse_errors.fetch_add(1);
+    metrics_.userspace_rejected.fetch_add(1);
+  }
+
+  // Kernel drop counters of the listening sockets that are still open.
+  // Called with sockets_mutex_ held.
+  uint64_t LiveKernelDropsLocked() const {
+    uint64_t drops = 0;
+    for (const auto& iface : interfaces_) {
+      for (const UdpSocket* listener : iface->listeners()) {
+        drops += listener->KernelDrops();
+      }
+    }
+    return drops;
+  }
+
+  // Open the sockets of every configured interface. In passive receive modes
+  // the beat and status sockets use ephemeral ports and only send.
+  bool OpenSockets(bool passive_receive) {
+    std::lock_guard<std::mutex> lock(sockets_mutex_);
+    for (size_t i = 0; i < interfaces_.size(); ++i) {
+      NetInterface* iface = interfaces_[i].get();
+      SocketOptions options;
+      options.recv_buffer_bytes = config_.recv_buffer_bytes;
+      options.send_buffer_bytes = config_.send_buffer_bytes;
+      options.device = iface->config.name;
+      options.interface_index = static_cast<uint8_t>(i);
+      const std::string& bind = iface->config.bind_address;
+      UdpSocket* failed = nullptr;
+      if (!iface->beat_socket.Open(passive_receive ? 0 : kBeatPort, bind, true, options)) {
+        failed = &iface->beat_socket;
+      } else if (!iface->status_socket.Open(passive_receive ? 0 : kStatusPort, bind, true,
+                                            options)) {
+        failed = &iface->status_socket;
+      } else if (!passive_receive &&
+                 !iface->device_socket.Open(kAnnouncePort, bind, true, options)) {
+        failed = &iface->device_socket;
+      } else {
+        // Send-only socket: only the send buffer size applies.
+        SocketOptions announce_options = options;
+        announce_options.recv_buffer_bytes = 0;
+        if (!iface->announce_socket.Open(0, bind, true, announce_options)) {
+          failed = &iface->announce_socket;
+        }
+      }
+      if (failed) {
+        start_error_ = failed->last_error();
+        if (interfaces_.size() > 1) {
+          start_error_ = "interface " + std::to_string(i) + ": " + start_error_;
+        }
+        CloseSocketsLocked();
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Close every socket under sockets_mutex_, which GetMetrics() holds while
+  // it reads them. Drops counted on the listening sockets move to
+  // kernel_drops_closed under the same lock, so a snapshot counts them once.
+  void CloseSockets() {
+    std::lock_guard<std::mutex> lock(sockets_mutex_);
+    CloseSocketsLocked();
+  }
+
+  void CloseSocketsLocked() {
+    metrics_.kernel_drops_closed.fetch_add(LiveKernelDropsLocked());
+    for (const auto& iface : interfaces_) {
+      iface->beat_socket.Close();
+      iface->status_socket.Close();
+      iface->device_socket.Close();
+      iface->announce_socket.Close();
+    }
+  }
+
+  void RecordTruncated(const DatagramClass& cls) {
+    if (cls.verdict == DatagramVerdict::kNotProlink) {
+      metrics_.userspace_rejected.fetch_add(1);
+      return;
+    }
+    metrics_.truncated_by_type[cls.type].fetch_add(1);
   }
 
   void RecordPacketReceived() {
     metrics_.packets_received.fetch_add(1);
   }
 
-  void CapturePacket(const uint8_t* data, size_t length) {
+  // Capture records (version 1) are a microsecond timestamp, the datagram
+  // length, the local receive port and the datagram, host byte order.
+  void CapturePacket(const uint8_t* data, size_t length, uint16_t local_port,
+                     std::chrono::steady_clock::time_point receive_time) {
     if (!capture_stream_.is_open()) {
       return;
     }
-    const auto now = std::chrono::steady_clock::now().time_since_epoch();
     const uint64_t timestamp_us =
-        std::chrono::duration_cast<std::chrono::microseconds>(now).count();
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            receive_time.time_since_epoch())
+            .count();
     const uint32_t length_u32 = static_cast<uint32_t>(length);
     std::lock_guard<std::mutex> lock(capture_mutex_);
     capture_stream_.write(reinterpret_cast<const char*>(&timestamp_us),
                           sizeof(timestamp_us));
     capture_stream_.write(reinterpret_cast<const char*>(&length_u32),
                           sizeof(length_u32));
+    capture_stream_.write(reinterpret_cast<const char*>(&local_port),
+                          sizeof(local_port));
     capture_stream_.write(reinterpret_cast<const char*>(data),
                           static_cast<std::streamsize>(length));
   }
 
-  bool ReadReplayPacket(uint64_t* timestamp_us, std::vector<uint8_t>* packet) {
+  // Detect the capture format. A legacy capture starts directly with its
+  // first record, so the stream is rewound when the magic is missing.
+  bool ReadReplayHeader() {
+    char magic[sizeof(kCaptureMagic)] = {};
+    uint32_t version = 0;
+    replay_stream_.read(magic, sizeof(magic));
+    replay_stream_.read(reinterpret_cast<char*>(&version), sizeof(version));
+    if (!replay_stream_ || std::memcmp(magic, kCaptureMagic, sizeof(magic)) != 0) {
+      replay_stream_.clear();
+      replay_stream_.seekg(0);
+      replay_version_ = 0;
+      return true;
+    }
+    if (version != kCaptureVersion) {
+      start_error_ = "unsupported replay file version " + std::to_string(version) + ": " +
+                     config_.replay_file;
+      return false;
+    }
+    replay_version_ = version;
+    return true;
+  }
+
+  bool ReadReplayPacket(uint64_t* timestamp_us, uint16_t* local_port,
+                        std::vector<uint8_t>* packet) {
     if (!replay_stream_.is_open()) {
       return false;
     }
@@ -1017,6 +3063,13 @@ struct Session::Impl {
     if (!replay_stream_) {
       return false;
     }
+    uint16_t port = kAnyPort;
+    if (replay_version_ >= 1) {
+      replay_stream_.read(reinterpret_cast<char*>(&port), sizeof(port));
+      if (!replay_stream_) {
+        return false;
+      }
+    }
     if (length > kMaxReplayPacketSize) {
       LogError("Replay packet too large, aborting", &config_);
       return false;
@@ -1032,179 +3085,515 @@ struct Session::Impl {
     if (timestamp_us) {
       *timestamp_us = ts;
     }
+    if (local_port) {
+      *local_port = port;
+    }
     if (packet) {
       *packet = std::move(data);
     }
     return true;
   }
 
-  void ProcessPacket(const uint8_t* data, size_t length,
-                     const std::string& addr_string) {
-    if (length < kHeaderSize) {
+  // Decode a classified datagram. The classifier has already checked the
+  // magic, that the type is expected on the receive port and the minimum
+  // length for the type, so the cases below read their fields without further
+  // bounds checks.
+  void ProcessPacket(const uint8_t* data, size_t length, const DatagramClass& cls,
+                     const PacketMeta& meta) {
+    if (cls.verdict == DatagramVerdict::kNotProlink) {
       RecordParseError();
       return;
     }
-    if (!HasHeader(data, length)) {
+    RecordPacketReceived();
+    if (cls.verdict == DatagramVerdict::kShort) {
       RecordParseError();
       return;
     }
-    if (length <= kPacketTypeOffset) {
-      RecordParseError();
+    if (cls.verdict == DatagramVerdict::kWrongPort) {
+      metrics_.userspace_rejected.fetch_add(1);
       return;
     }
-    RecordPacketReceived();
-    const uint8_t type = data[kPacketTypeOffset];
-    switch (type) {
+    switch (cls.type) {
       case static_cast<uint8_t>(PacketType::kBeat): {
-        BeatInfo info;
-        if (!ParseBeat(data, length, &info)) {
+        const BeatView view(data, length, meta.receive_time, meta.interface_index);
+        UpdateDeviceSeen(view.device_number(), view.device_name(), meta);
+        HandleBeat(view);
+        return;
+      }
+      case static_cast<uint8_t>(PacketType::kPrecisePosition): {
+        PositionInfo info;
+        DecodePosition(data, length, &info);
+        info.receive_time = meta.receive_time;
+        info.interface_index = meta.interface_index;
+        UpdateDeviceSeen(info.device_number, DeviceNameViewAt(data, length, kDeviceNameOffset),
+                         meta);
+        HandlePosition(info);
+        return;
+      }
+      case static_cast<uint8_t>(PacketType::kChannelsOnAir): {
+        OnAirInfo info;
+        DecodeOnAir(data, length, &info);
+        info.receive_time = meta.receive_time;
+        UpdateDeviceSeen(info.device_number, DeviceNameViewAt(data, length, kDeviceNameOffset),
+                         meta);
+        mixer_channels_.SetOnAir(info);
+        Notify(on_air_cb_, info, "OnAirCallback");
+        return;
+      }
+      case static_cast<uint8_t>(PacketType::kFaderStart): {
+        FaderStartInfo info;
+        if (!DecodeFaderStart(data, length, &info)) {
           RecordParseError();
           return;
         }
-        UpdateDeviceSeen(info.device_number, info.device_name, addr_string);
-        HandleBeat(info);
+        info.receive_time = meta.receive_time;
+        UpdateDeviceSeen(info.device_number, DeviceNameViewAt(data, length, kDeviceNameOffset),
+                         meta);
+        mixer_channels_.SetFaderStart(info);
+        Notify(fader_start_cb_, info, "FaderStartCallback");
+        return;
+      }
+      case static_cast<uint8_t>(PacketType::kMixerStatus): {
+        const uint8_t device_number = MixerStatusLayout::DeviceNumber::Read(data);
+        UpdateDeviceSeen(device_number, DeviceNameViewAt(data, length, kDeviceNameOffset),
+                         meta);
+        HandleMixerStatus(data, length, meta);
         return;
       }
       case static_cast<uint8_t>(PacketType::kCdjStatus): {
-        StatusInfo info;
-        if (!ParseStatus(data, length, &info)) {
-          RecordParseError();
-          return;
-        }
-        UpdateDeviceSeen(info.device_number, info.device_name, addr_string);
-        HandleStatus(info);
+        const StatusView view(data, length, meta.receive_time, meta.interface_index);
+        UpdateDeviceSeen(view.device_number(), view.device_name(), meta);
+        HandleStatus(view);
         return;
       }
       case static_cast<uint8_t>(PacketType::kSyncControl): {
-        if (length <= kOffsetMasterHandoffAccepted ||
-            length <= kOffsetDeviceNumber) {
-          RecordParseError();
-          return;
-        }
-        const uint8_t device_number = data[kOffsetDeviceNumber];
-        UpdateDeviceSeen(device_number, ParseDeviceName(data, length), addr_string);
-        HandleSyncControl(device_number, data[kOffsetMasterHandoffAccepted]);
+        const uint8_t device_number = ControlLayout::DeviceNumber::Read(data);
+        UpdateDeviceSeen(device_number, DeviceNameViewAt(data, length, kDeviceNameOffset),
+                         meta);
+        HandleSyncControl(device_number, ControlLayout::Command::Read(data));
         return;
       }
       case static_cast<uint8_t>(PacketType::kMasterHandoffRequest): {
-        if (length <= kOffsetDeviceNumber) {
-          RecordParseError();
-          return;
-        }
-        const uint8_t device_number = data[kOffsetDeviceNumber];
-        UpdateDeviceSeen(device_number, ParseDeviceName(data, length), addr_string);
+        const uint8_t device_number = ControlLayout::DeviceNumber::Read(data);
+        UpdateDeviceSeen(device_number, DeviceNameViewAt(data, length, kDeviceNameOffset),
+                         meta);
         HandleMasterHandoffRequest(device_number);
         return;
       }
-      case static_cast<uint8_t>(PacketType::kMasterHandoffResponse): {
-        if (length <= kOffsetMasterHandoffAccepted ||
-            length <= kOffsetDeviceNumber) {
-          RecordParseError();
-          return;
-        }
-        const uint8_t device_number = data[kOffsetDeviceNumber];
-        UpdateDeviceSeen(device_number, ParseDeviceName(data, length), addr_string);
-        HandleMasterHandoffResponse(device_number,
-                                    data[kOffsetMasterHandoffAccepted] == 0x01);
-        return;
+      case static_cast<uint8_t>(PacketType::kMasterHandoffResponse): {
+        const uint8_t device_number = ControlLayout::DeviceNumber::Read(data);
+        UpdateDeviceSeen(device_number, DeviceNameViewAt(data, length, kDeviceNameOffset),
+                         meta);
+        HandleMasterHandoffResponse(device_number, ControlLayout::Command::Read(data) == 0x01);
+        return;
+      }
+      case static_cast<uint8_t>(PacketType::kDeviceKeepAlive): {
+        const KeepAliveView view(data, length, meta.receive_time, meta.interface_index);
+        HandleKeepAliveView(view);
+        UpdateDeviceFromKeepAlive(KeepAliveFromView(view), meta);
+        return;
+      }
+      default:
+        metrics_.userspace_rejected.fetch_add(1);
+        return;
+    }
+  }
+
+  // Drop non-Pro-DJ-Link datagrams in the kernel on the listening sockets.
+  bool AttachKernelFilters() {
+    for (const auto& iface : interfaces_) {
+      for (UdpSocket* listener : iface->listeners()) {
+        if (!listener->AttachProlinkFilter(listener->port())) {
+          start_error_ = listener->last_error();
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
+  // Register the listening sockets with the receive reactor.
+  bool OpenRecvReactor() {
+#ifdef PROLINK_HAVE_IO_URING
+    if (config_.recv_backend == RecvBackend::kIoUring) {
+      io_uring_.reset(new IoUringReactor());
+      if (!io_uring_->Open()) {
+        start_error_ = io_uring_->last_error();
+        io_uring_.reset();
+        return false;
+      }
+      for (const auto& iface : interfaces_) {
+        for (UdpSocket* socket : iface->listeners()) {
+          if (socket->fd() >= 0 && !io_uring_->AddReceiver(socket)) {
+            start_error_ = io_uring_->last_error();
+            io_uring_.reset();
+            return false;
+          }
+        }
+      }
+      return true;
+    }
+#endif
+    const bool busy_poll = config_.recv_backend == RecvBackend::kBusyPoll;
+    const bool use_beat_lane = config_.beat_lane && !monitor_mode_;
+    bool use_epoll = false;
+#ifdef __linux__
+    use_epoll = config_.recv_backend != RecvBackend::kSelect;
+#endif
+    for (RecvLane* lane : {&recv_lane_, &beat_lane_}) {
+      lane->sockets.clear();
+      if (busy_poll || (lane == &beat_lane_ && !use_beat_lane)) {
+        continue;
+      }
+      if (!lane->reactor.Open(use_epoll)) {
+        start_error_ = lane->reactor.last_error();
+        return false;
+      }
+    }
+#ifdef __linux__
+    if (monitor_mode_) {
+      if (!sniffer_.Open(config_.monitor_interface)) {
+        start_error_ = sniffer_.last_error();
+        return false;
+      }
+      if (!recv_lane_.reactor.Add(sniffer_.fd(), kSnifferTag)) {
+        start_error_ = recv_lane_.reactor.last_error();
+        sniffer_.Close();
+        return false;
       }
-      case static_cast<uint8_t>(PacketType::kDeviceKeepAlive): {
-        KeepAliveInfo info;
-        if (!ParseKeepAlive(data, length, &info)) {
-          RecordParseError();
-          return;
+      return true;
+    }
+#endif
+    for (const auto& iface : interfaces_) {
+      for (UdpSocket* socket : iface->listeners()) {
+        if (socket->fd() < 0) {
+          continue;
         }
-        UpdateDeviceFromKeepAlive(info);
-        return;
+        RecvLane& lane =
+            use_beat_lane && socket == &iface->beat_socket ? beat_lane_ : recv_lane_;
+        if (busy_poll) {
+          if (config_.busy_poll_us > 0 && !socket->EnableBusyPoll(config_.busy_poll_us)) {
+            LogError("SO_BUSY_POLL unavailable: " + std::string(std::strerror(errno)) +
+                         "; spinning in userspace only",
+                     &config_);
+          }
+        } else if (!lane.reactor.Add(socket->fd(), lane.sockets.size())) {
+          start_error_ = lane.reactor.last_error();
+          return false;
+        }
+        lane.sockets.push_back(socket);
       }
-      default:
-        return;
     }
+    return true;
+  }
+
+  // Raise the beat lane thread to SCHED_FIFO if configured. Best effort.
+  void SetBeatLanePriority() {
+    if (config_.beat_lane_priority <= 0) {
+      return;
+    }
+    sched_param param{};
+    param.sched_priority = config_.beat_lane_priority;
+    const int result =
+        ::pthread_setschedparam(beat_lane_.thread.native_handle(), SCHED_FIFO, &param);
+    if (result != 0) {
+      LogError("beat lane priority not applied: " + std::string(std::strerror(result)),
+               &config_);
+    }
+  }
+
+  // One receive ring per lane socket, with slots sized for its port.
+  std::vector<RecvRing> MakeRecvRings(const RecvLane& lane) const {
+    std::vector<RecvRing> rings;
+    rings.reserve(lane.sockets.size());
+    for (const UdpSocket* socket : lane.sockets) {
+      rings.emplace_back(static_cast<size_t>(config_.recv_batch_size),
+                         RecvSlotSize(socket->port()));
+    }
+    return rings;
   }
 
-  // Receive loop for beat/status sockets.
-  void RecvLoop() {
+  // Receive loop for the sockets of one lane.
+  void RecvLoop(RecvLane& lane) {
     if (replay_mode_) {
       ReplayLoop();
       return;
     }
-    std::array<uint8_t, 512> buffer{};
+#ifdef PROLINK_HAVE_IO_URING
+    if (io_uring_) {
+      IoUringLoop();
+      return;
+    }
+#endif
+    if (config_.recv_backend == RecvBackend::kBusyPoll) {
+      BusyPollLoop(lane);
+      return;
+    }
+    std::vector<RecvRing> rings = MakeRecvRings(lane);
+    std::vector<size_t> ready;
+    ready.reserve(lane.sockets.size());
+    RawCallbackCache raw_cb;
     while (running_) {
-      fd_set readfds;
-      FD_ZERO(&readfds);
-      int max_fd = -1;
-      const int beat_fd = beat_socket_.fd();
-      const int status_fd = status_socket_.fd();
-      const int device_fd = device_socket_.fd();
-      if (beat_fd >= 0) {
-        FD_SET(beat_fd, &readfds);
-        max_fd = std::max(max_fd, beat_fd);
-      }
-      if (status_fd >= 0) {
-        FD_SET(status_fd, &readfds);
-        max_fd = std::max(max_fd, status_fd);
-      }
-      if (device_fd >= 0) {
-        FD_SET(device_fd, &readfds);
-        max_fd = std::max(max_fd, device_fd);
-      }
-      if (max_fd < 0) {
+      const int count = lane.reactor.Wait(&ready);
+      if (count < 0) {
         if (!running_) {
           return;
         }
-        LogError("RecvLoop: no valid sockets, stopping", &config_);
+        LogError("RecvLoop: wait failed: " + std::string(std::strerror(errno)) +
+                     ", stopping",
+                 &config_);
         running_ = false;
         return;
       }
-      timeval tv{};
-      tv.tv_sec = 0;
-      tv.tv_usec = 200000;
-      const int ready = ::select(max_fd + 1, &readfds, nullptr, nullptr, &tv);
-      if (ready <= 0) {
+      if (count == 0) {
         continue;
       }
-      if (beat_fd >= 0 && FD_ISSET(beat_fd, &readfds)) {
-        sockaddr_in addr{};
-        socklen_t addr_len = sizeof(addr);
-        const ssize_t bytes = beat_socket_.RecvFrom(buffer.data(), buffer.size(),
-                                                    &addr, &addr_len);
-        if (bytes > 0) {
-          const size_t length = static_cast<size_t>(bytes);
-          CapturePacket(buffer.data(), length);
-          ProcessPacket(buffer.data(), length, AddrToString(addr));
+      metrics_.receive_wakeups.fetch_add(1);
+      const RawPacketCallback& callback = RefreshRawCallback(&raw_cb);
+      for (const size_t tag : ready) {
+#ifdef __linux__
+        if (tag == kSnifferTag) {
+          DrainSniffer(callback);
+          continue;
         }
+#endif
+        DrainSocket(*lane.sockets[tag], &rings[tag], callback);
+      }
+    }
+  }
+
+  // Poll every listening socket without sleeping. Each poll that finds
+  // data counts as a receive wakeup.
+  void BusyPollLoop(const RecvLane& lane) {
+    std::vector<RecvRing> rings = MakeRecvRings(lane);
+    unsigned idle_polls = 0;
+    RawCallbackCache raw_cb;
+    while (running_) {
+      const RawPacketCallback& callback = RefreshRawCallback(&raw_cb);
+      size_t received = 0;
+      for (size_t i = 0; i < lane.sockets.size(); ++i) {
+        received += DrainSocket(*lane.sockets[i], &rings[i], callback);
+      }
+      if (received > 0) {
+        metrics_.receive_wakeups.fetch_add(1);
+        idle_polls = 0;
+        continue;
+      }
+      switch (config_.busy_poll_backoff) {
+        case BusyPollBackoff::kSpin:
+          break;
+        case BusyPollBackoff::kPause:
+          CpuRelax();
+          break;
+        case BusyPollBackoff::kYield:
+          CpuRelax();
+          if (++idle_polls >= kBusyPollYieldAfter) {
+            idle_polls = 0;
+            std::this_thread::yield();
+          }
+          break;
+      }
+    }
+  }
+
+  // Read queued datagrams from a socket in batches until it would block and
+  // return how many were read. A short batch means recvmmsg hit EAGAIN, which
+  // is what edge-triggered epoll needs before the next wait.
+  size_t DrainSocket(UdpSocket& socket, RecvRing* ring, const RawPacketCallback& raw_cb) {
+    size_t total = 0;
+    while (running_) {
+      const int count = socket.RecvBatch(ring);
+      if (count <= 0) {
+        return total;
       }
-      if (status_fd >= 0 && FD_ISSET(status_fd, &readfds)) {
-        sockaddr_in addr{};
-        socklen_t addr_len = sizeof(addr);
-        const ssize_t bytes = status_socket_.RecvFrom(buffer.data(), buffer.size(),
-                                                      &addr, &addr_len);
-        if (bytes > 0) {
-          const size_t length = static_cast<size_t>(bytes);
-          CapturePacket(buffer.data(), length);
-          ProcessPacket(buffer.data(), length, AddrToString(addr));
+      total += static_cast<size_t>(count);
+      metrics_.datagrams_received.fetch_add(static_cast<uint64_t>(count));
+      if (config_.parse_packets) {
+        ring->Classify(static_cast<size_t>(count), socket.port());
+      }
+      for (int i = 0; i < count; ++i) {
+        const size_t length = ring->length(i);
+        if (length == 0) {
+          continue;
+        }
+        if (!DeliverRaw(raw_cb, ring->data(i), length, ring->source(i), socket.port(),
+                        socket.interface_index(), ring->receive_time(i), ring->truncated(i))) {
+          continue;
         }
+        DispatchDatagram(ring->data(i), length, ring->datagram_class(i), ring->source(i),
+                         socket.port(), socket.interface_index(), ring->receive_time(i),
+                         ring->truncated(i));
+      }
+      if (static_cast<size_t>(count) < ring->capacity()) {
+        return total;
+      }
+    }
+    return total;
+  }
+
+#ifdef __linux__
+  // Feed every captured frame in the ready ring blocks through the pipeline.
+  void DrainSniffer(const RawPacketCallback& raw_cb) {
+    const int count = sniffer_.Drain(
+        [this, &raw_cb](const uint8_t* data, size_t length, const sockaddr_in& source,
+                        uint16_t destination_port,
+                        std::chrono::steady_clock::time_point receive_time, bool truncated) {
+          if (length > 0 && DeliverRaw(raw_cb, data, length, source, destination_port, 0,
+                                       receive_time, truncated)) {
+            DispatchDatagram(data, length, ClassifyDatagram(data, length, destination_port),
+                             source, destination_port, 0, receive_time, truncated);
+          }
+        });
+    metrics_.datagrams_received.fetch_add(static_cast<uint64_t>(count));
+  }
+#endif
+
+  // Apply the per-source rate limit. Malformed datagrams pass through so
+  // ProcessPacket can reject them.
+  bool AdmitPacket(const uint8_t* data, size_t length, const DatagramClass& cls,
+                   const sockaddr_in& source, std::chrono::steady_clock::time_point receive_time) {
+    if (cls.verdict == DatagramVerdict::kNotProlink) {
+      return true;
+    }
+    const uint8_t type = cls.type;
+    const size_t device_offset = type == static_cast<uint8_t>(PacketType::kDeviceKeepAlive)
+                                     ? KeepAliveLayout::DeviceNumber::kOffset
+                                     : kOffsetDeviceNumber;
+    const uint8_t device = length > device_offset ? data[device_offset] : 0;
+    return rate_limiter_.Allow(type, source.sin_addr.s_addr, device, receive_time);
+  }
+
+  // A receive thread's copy of the raw packet callback.
+  struct RawCallbackCache {
+    RawPacketCallback callback;
+    uint64_t generation = ~uint64_t{0};
+  };
+
+  // Refresh `cache` if SetRawPacketCallback() ran since the last call. The
+  // common case is one atomic load, with no lock and no std::function copy.
+  const RawPacketCallback& RefreshRawCallback(RawCallbackCache* cache) {
+    if (raw_packet_cb_generation_.load(std::memory_order_acquire) != cache->generation) {
+      std::lock_guard<std::mutex> lock(callback_mutex_);
+      cache->callback = raw_packet_cb_;
+      cache->generation = raw_packet_cb_generation_.load(std::memory_order_relaxed);
+    }
+    return cache->callback;
+  }
+
+  // Hand a received datagram to the raw packet callback. Returns false when
+  // Config::parse_packets is off; the datagram is then only captured.
+  bool DeliverRaw(const RawPacketCallback& raw_cb, const uint8_t* data, size_t length,
+                  const sockaddr_in& source, uint16_t local_port, uint8_t interface_index,
+                  std::chrono::steady_clock::time_point receive_time, bool truncated) {
+    if (raw_cb) {
+      RawPacket packet;
+      packet.data = data;
+      packet.size = length;
+      packet.source_ip = source.sin_addr.s_addr;
+      packet.source_port = ntohs(source.sin_port);
+      packet.local_port = local_port;
+      packet.interface_index = interface_index;
+      packet.truncated = truncated;
+      packet.receive_time = receive_time;
+      try {
+        raw_cb(packet);
+      } catch (...) {
+        RecordCallbackException("RawPacketCallback");
       }
-      if (device_fd >= 0 && FD_ISSET(device_fd, &readfds)) {
-        sockaddr_in addr{};
-        socklen_t addr_len = sizeof(addr);
-        const ssize_t bytes = device_socket_.RecvFrom(buffer.data(), buffer.size(),
-                                                      &addr, &addr_len);
-        if (bytes > 0) {
-          const size_t length = static_cast<size_t>(bytes);
-          CapturePacket(buffer.data(), length);
-          ProcessPacket(buffer.data(), length, AddrToString(addr));
+    }
+    if (config_.parse_packets) {
+      return true;
+    }
+    if (!truncated) {
+      CapturePacket(data, length, local_port, receive_time);
+    }
+    return false;
+  }
+
+  // Capture and process one received datagram. Truncated datagrams are
+  // counted by packet type and never parsed; with several interfaces, a copy
+  // already received on another interface is dropped before rate limiting.
+  void DispatchDatagram(const uint8_t* data, size_t length, const DatagramClass& cls,
+                        const sockaddr_in& source, uint16_t local_port, uint8_t interface_index,
+                        std::chrono::steady_clock::time_point receive_time,
+                        bool truncated) {
+    if (truncated) {
+      RecordTruncated(cls);
+      return;
+    }
+    if (interfaces_.size() > 1 &&
+        duplicate_filter_.IsDuplicate(data, length, interface_index, receive_time)) {
+      return;
+    }
+    if (!AdmitPacket(data, length, cls, source, receive_time)) {
+      return;
+    }
+    PacketMeta meta;
+    meta.source_ip = source.sin_addr.s_addr;
+    meta.receive_time = receive_time;
+    meta.interface_index = interface_index;
+    CapturePacket(data, length, local_port, meta.receive_time);
+    ProcessPacket(data, length, cls, meta);
+  }
+
+#ifdef PROLINK_HAVE_IO_URING
+  // Receive loop for the io_uring backend; also completes queued sends.
+  void IoUringLoop() {
+    RawCallbackCache raw_cb;
+    const IoUringReactor::RecvHandler on_recv =
+        [this, &raw_cb](const uint8_t* data, size_t length, const sockaddr_in& source,
+                        uint16_t local_port, uint8_t interface_index,
+                        std::chrono::steady_clock::time_point receive_time, bool truncated) {
+          if (length > 0 && DeliverRaw(raw_cb.callback, data, length, source, local_port,
+                                       interface_index, receive_time, truncated)) {
+            DispatchDatagram(data, length, ClassifyDatagram(data, length, local_port), source,
+                             local_port, interface_index, receive_time, truncated);
+          }
+        };
+    const IoUringReactor::SendHandler on_send =
+        [this](const char* packet_type, ssize_t result, size_t expected) {
+          RecordSendResult(packet_type, result, expected);
+        };
+    while (running_) {
+      RefreshRawCallback(&raw_cb);
+      const int count = io_uring_->WaitAndDispatch(on_recv, on_send);
+      if (count < 0) {
+        if (!running_) {
+          return;
         }
+        LogError("RecvLoop: io_uring wait failed: " + std::string(std::strerror(errno)) +
+                     ", stopping",
+                 &config_);
+        running_ = false;
+        return;
       }
+      if (count > 0) {
+        metrics_.receive_wakeups.fetch_add(1);
+        metrics_.datagrams_received.fetch_add(static_cast<uint64_t>(count));
+      }
+    }
+  }
+#endif
+
+  // Send a packet through the io_uring queue when available, else sendto().
+  void SendPacket(UdpSocket& socket, const char* packet_type, const uint8_t* data, size_t size,
+                  const sockaddr_in& addr) {
+#ifdef PROLINK_HAVE_IO_URING
+    if (io_uring_ && io_uring_->Send(socket.fd(), data, size, addr, packet_type)) {
+      return;
     }
+#endif
+    const ssize_t result = socket.SendTo(data, size, addr);
+    RecordSendResult(packet_type, result, size);
   }
 
   void ReplayLoop() {
     uint64_t last_timestamp = 0;
     while (running_) {
       uint64_t timestamp = 0;
+      uint16_t local_port = kAnyPort;
       std::vector<uint8_t> packet;
-      if (!ReadReplayPacket(&timestamp, &packet)) {
+      if (!ReadReplayPacket(&timestamp, &local_port, &packet)) {
         LogError("Replay file exhausted, stopping", &config_);
         running_ = false;
         return;
@@ -1214,20 +3603,76 @@ struct Session::Impl {
         std::this_thread::sleep_for(std::chrono::microseconds(delta_us));
       }
       last_timestamp = timestamp;
-      ProcessPacket(packet.data(), packet.size(), {});
+      PacketMeta meta;
+      meta.receive_time = std::chrono::steady_clock::now();
+      ProcessPacket(packet.data(), packet.size(),
+                    ClassifyDatagram(packet.data(), packet.size(), local_port), meta);
+    }
+  }
+
+  // Call a user callback with exceptions contained; `member` is read under
+  // the callback mutex.
+  template <typename Callback, typename Info>
+  void Notify(const Callback& member, const Info& info, const char* name) {
+    Callback cb_copy;
+    {
+      std::lock_guard<std::mutex> lock(callback_mutex_);
+      cb_copy = member;
+    }
+    if (cb_copy) {
+      try {
+        cb_copy(info);
+      } catch (...) {
+        RecordCallbackException(name);
+      }
+    }
+  }
+
+  // MixerStatusInfo owns the device name, so it is only built for a callback.
+  void HandleMixerStatus(const uint8_t* data, size_t length, const PacketMeta& meta) {
+    MixerStatusCallback cb_copy;
+    {
+      std::lock_guard<std::mutex> lock(callback_mutex_);
+      cb_copy = mixer_status_cb_;
+    }
+    if (!cb_copy) {
+      return;
+    }
+    const MixerStatusInfo info =
+        Materialize(MixerStatusView(data, length, meta.receive_time, meta.interface_index));
+    try {
+      cb_copy(info);
+    } catch (...) {
+      RecordCallbackException("MixerStatusCallback");
     }
   }
 
+  // Publish the position for GetLatestPosition() before the callback runs.
+  void HandlePosition(const PositionInfo& info) {
+    positions_.Store(info);
+    Notify(position_cb_, info, "PositionCallback");
+  }
+
   // Handle an incoming beat packet (optional follow-master alignment).
-  void HandleBeat(const BeatInfo& info) {
+  void HandleBeat(const BeatView& view) {
+    metrics_.beat_latency.Record(view.receive_time());
+    BeatViewCallback view_cb_copy;
     BeatCallback cb_copy;
     {
       std::lock_guard<std::mutex> lock(callback_mutex_);
+      view_cb_copy = beat_view_cb_;
       cb_copy = beat_cb_;
     }
+    if (view_cb_copy) {
+      try {
+        view_cb_copy(view);
+      } catch (...) {
+        RecordCallbackException("BeatViewCallback");
+      }
+    }
     if (cb_copy) {
       try {
-        cb_copy(info);
+        cb_copy(Materialize(view));
       } catch (...) {
         RecordCallbackException("BeatCallback");
       }
@@ -1237,65 +3682,86 @@ struct Session::Impl {
     }
     std::lock_guard<std::mutex> lock(state_mutex_);
     if (master_device_number_ != 0 &&
-        info.device_number == master_device_number_) {
-      const auto now = std::chrono::steady_clock::now();
+        view.device_number() == master_device_number_) {
       if (master_beat_number_ != 0) {
         master_beat_number_ += 1;
-        clock_.AlignToBeatNumber(master_beat_number_, info.beat_within_bar, now);
+        clock_.AlignToBeatNumber(master_beat_number_, view.beat_within_bar(),
+                                 view.receive_time());
         last_sent_beat_ = 0;
       } else {
-        clock_.AlignToBeatWithinBar(info.beat_within_bar, now);
+        clock_.AlignToBeatWithinBar(view.beat_within_bar(), view.receive_time());
         last_sent_beat_ = 0;
       }
     }
   }
 
-  // Handle an incoming status packet (updates tempo master state).
-  void HandleStatus(const StatusInfo& info) {
+  // Handle an incoming status packet (updates tempo master state). An owning
+  // StatusInfo is only built for the StatusCallback and for master status.
+  void HandleStatus(const StatusView& view) {
+    metrics_.status_latency.Record(view.receive_time());
+    StatusViewCallback view_cb_copy;
     StatusCallback cb_copy;
+    uint32_t fields = kStatusFieldsCore;
     {
       std::lock_guard<std::mutex> lock(callback_mutex_);
+      view_cb_copy = status_view_cb_;
       cb_copy = status_cb_;
+      fields = status_fields_;
+    }
+    if (view_cb_copy) {
+      try {
+        view_cb_copy(view);
+      } catch (...) {
+        RecordCallbackException("StatusViewCallback");
+      }
+    }
+    const uint8_t device_number = view.device_number();
+    const bool is_master = view.is_master();
+    std::optional<StatusInfo> info;
+    if (cb_copy || is_master) {
+      // The master's record is kept whole for GetTempoMaster().
+      info = Materialize(view, is_master ? kStatusFieldsAll : fields);
     }
     if (cb_copy) {
       try {
-        cb_copy(info);
+        cb_copy(*info);
       } catch (...) {
         RecordCallbackException("StatusCallback");
       }
     }
     bool should_request_new_master = false;
     uint8_t request_target = 0;
-    if (info.is_master) {
+    if (is_master) {
       const auto now = std::chrono::steady_clock::now();
       std::lock_guard<std::mutex> lock(state_mutex_);
       if (requesting_master_from_ != 0 &&
-          requesting_master_from_ != info.device_number) {
-        if (info.device_number == config_.device_number) {
+          requesting_master_from_ != device_number) {
+        if (device_number == config_.device_number) {
           requesting_master_from_ = 0;
           master_request_attempts_ = 0;
           master_request_time_ = std::chrono::steady_clock::time_point{};
           master_request_start_time_ = std::chrono::steady_clock::time_point{};
         } else {
           LogError("Master changed during handoff request, restarting", &config_);
-          requesting_master_from_ = info.device_number;
+          requesting_master_from_ = device_number;
           master_request_attempts_ = 1;
           master_request_time_ = now;
           master_request_start_time_ = now;
-          request_target = info.device_number;
+          request_target = device_number;
           should_request_new_master = true;
         }
       }
       master_status_ = info;
-      master_device_number_ = info.device_number;
-      if (info.beat.has_value()) {
-        master_beat_number_ = info.beat.value();
+      master_device_number_ = device_number;
+      if (info->beat.has_value()) {
+        master_beat_number_ = info->beat.value();
       }
-      if (config_.follow_master && info.bpm.has_value() && info.beat.has_value()) {
-        const double bpm = info.bpm.value() / 100.0;
+      if (config_.follow_master && info->bpm.has_value() && info->beat.has_value()) {
+        const double bpm = info->bpm.value() / 100.0;
         state_.tempo_bpm = bpm;
         clock_.SetTempo(bpm);
-        clock_.AlignToBeatNumber(info.beat.value(), info.beat_within_bar, now);
+        clock_.AlignToBeatNumber(info->beat.value(), info->beat_within_bar,
+                                 info->receive_time);
         state_.synced = true;
         last_sent_beat_ = 0;
       }
@@ -1303,7 +3769,7 @@ struct Session::Impl {
     if (should_request_new_master) {
       SendMasterHandoffRequestInternal(request_target);
     }
-    if (info.master_handoff_to == config_.device_number) {
+    if (view.master_handoff_to() == config_.device_number) {
       std::lock_guard<std::mutex> lock(state_mutex_);
       state_.master = true;
       state_.synced = true;
@@ -1313,8 +3779,7 @@ struct Session::Impl {
       master_request_attempts_ = 0;
       master_request_start_time_ = std::chrono::steady_clock::time_point{};
     }
-    if (handoff_to_device_ != 0xff && info.device_number == handoff_to_device_ &&
-        info.is_master) {
+    if (handoff_to_device_ != 0xff && device_number == handoff_to_device_ && is_master) {
       std::lock_guard<std::mutex> lock(state_mutex_);
       state_.master = false;
       handoff_to_device_ = 0xff;
@@ -1324,6 +3789,7 @@ struct Session::Impl {
     }
   }
 
+
   // Schedule beat packets based on the local beat clock.
   void BeatLoop() {
     while (running_) {
@@ -1357,33 +3823,182 @@ struct Session::Impl {
     }
   }
 
-  // Periodically broadcast keep-alive packets on port 50000.
+  // Periodically broadcast keep-alive packets on port 50000. Interfaces
+  // without a device IP are skipped; ResolveNetwork() re-encodes the
+  // keep-alive when auto_network changes the announced address.
   void AnnounceLoop() {
-    if (config_.device_ip.empty()) {
+    if (!config_.auto_network && !HasDeviceIp()) {
       return;
     }
-    const auto packet = BuildAnnouncePacket(config_);
-    const auto addr = MakeSockaddr(config_.announce_address, kAnnouncePort);
     while (running_) {
-      const ssize_t result = announce_socket_.SendTo(packet, addr);
-      RecordSendResult("announce", result, packet.size());
+      for (const auto& iface : interfaces_) {
+        std::array<uint8_t, kMaxEncodedPacketSize> packet;
+        size_t size = 0;
+        {
+          std::lock_guard<std::mutex> lock(network_mutex_);
+          size = iface->keep_alive_size;
+          std::memcpy(packet.data(), iface->keep_alive.data(), size);
+        }
+        if (size == 0) {
+          continue;
+        }
+        SendPacket(iface->announce_socket, "announce", packet.data(), size,
+                   iface->announce_addr());
+      }
       std::this_thread::sleep_for(
           std::chrono::milliseconds(config_.announce_interval_ms));
     }
   }
 
+  bool HasDeviceIp() const {
+    std::lock_guard<std::mutex> lock(network_mutex_);
+    for (const auto& iface : interfaces_) {
+      if (!iface->device_ip.empty()) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Addresses of recently seen devices, most recent first, for
+  // auto_network interface selection.
+  std::vector<uint32_t> PeerAddresses() const {
+    std::vector<std::pair<std::chrono::steady_clock::time_point, uint32_t>> seen;
+    {
+      std::lock_guard<std::mutex> lock(devices_mutex_);
+      for (const auto& entry : devices_) {
+        if (entry.second.active && entry.second.ip_address != 0) {
+          seen.emplace_back(entry.second.info.last_seen, entry.second.ip_address);
+        }
+      }
+    }
+    std::sort(seen.begin(), seen.end(),
+              [](const auto& a, const auto& b) { return a.first > b.first; });
+    std::vector<uint32_t> peers;
+    for (const auto& entry : seen) {
+      peers.push_back(entry.second);
+    }
+    return peers;
+  }
+
+  // Resolve the auto_network fields of every interface from the host's
+  // current addresses. Fails only when an explicit selector (interface name
+  // or subnet) matches nothing at Start().
+  bool ResolveNetwork(bool starting) {
+    const std::vector<HostInterface> hosts = ListHostInterfaces();
+    const std::vector<uint32_t> peers = starting ? std::vector<uint32_t>{} : PeerAddresses();
+    for (size_t i = 0; i < interfaces_.size(); ++i) {
+      NetInterface& iface = *interfaces_[i];
+      if (!iface.auto_ip && !iface.auto_mac && !iface.auto_broadcast && !iface.auto_announce) {
+        continue;
+      }
+      const std::string& selector =
+          iface.config.name.empty() ? config_.network_interface : iface.config.name;
+      const HostInterface* host = SelectHostInterface(
+          hosts, selector, MakeSockaddr(iface.config.bind_address, 0).sin_addr.s_addr, peers);
+      if (!host) {
+        if (starting && !selector.empty()) {
+          start_error_ = "auto_network: no interface matches " + selector;
+          return false;
+        }
+        if (starting) {
+          LogError("auto_network: no broadcast-capable interface found yet", &config_);
+        }
+        continue;
+      }
+      std::lock_guard<std::mutex> lock(network_mutex_);
+      const std::string device_ip = Ipv4ToString(host->address);
+      if (!starting && host->name == iface.host_name &&
+          (!iface.auto_ip || device_ip == iface.device_ip) &&
+          (!iface.auto_broadcast || host->broadcast == iface.broadcast_ip.load())) {
+        continue;
+      }
+      if (!starting) {
+        LogError("auto_network: using " + host->name + " (" + device_ip + ")", &config_);
+      }
+      iface.host_name = host->name;
+      if (iface.auto_ip) {
+        iface.device_ip = device_ip;
+      }
+      if (iface.auto_mac) {
+        iface.mac_address = host->mac_address;
+      }
+      if (iface.auto_broadcast) {
+        iface.broadcast_ip.store(host->broadcast, std::memory_order_relaxed);
+      }
+      if (iface.auto_announce) {
+        iface.announce_ip.store(host->broadcast, std::memory_order_relaxed);
+      }
+      EncodeKeepAliveLocked(iface);
+    }
+    return true;
+  }
+
+  // Re-encode an interface's keep-alive after its address or MAC changed.
+  // Called with network_mutex_ held (or before any thread runs).
+  void EncodeKeepAliveLocked(NetInterface& iface) {
+    iface.keep_alive_size = 0;
+    if (iface.device_ip.empty()) {
+      return;
+    }
+    KeepAliveFields fields;
+    fields.device_number = config_.device_number;
+    fields.device_type = config_.device_type;
+    fields.device_name = config_.device_name;
+    fields.mac_address = iface.mac_address;
+    in_addr addr{};
+    if (inet_pton(AF_INET, iface.device_ip.c_str(), &addr) == 1) {
+      fields.ip_address = addr.s_addr;
+    }
+    iface.keep_alive_size =
+        EncodeKeepAlive(fields, iface.keep_alive.data(), iface.keep_alive.size());
+  }
+
+  // Encode the beat, status and control packets for this device. The device
+  // number and name are fixed for the session's lifetime, so this runs once.
+  void EncodeSendBuffers() {
+    BeatFields beat;
+    beat.device_number = config_.device_number;
+    beat.device_name = config_.device_name;
+    beat_packet_.size = EncodeBeat(beat, beat_packet_.data.data(), beat_packet_.data.size());
+
+    StatusFields status;
+    status.device_number = config_.device_number;
+    status.device_name = config_.device_name;
+    status_packet_.size =
+        EncodeStatus(status, status_packet_.data.data(), status_packet_.data.size());
+
+    sync_control_packet_.size =
+        EncodeSyncControl(config_.device_number, config_.device_name, SyncCommand::kEnableSync,
+                          sync_control_packet_.data.data(), sync_control_packet_.data.size());
+    handoff_request_packet_.size = EncodeMasterHandoffRequest(
+        config_.device_number, config_.device_name, handoff_request_packet_.data.data(),
+        handoff_request_packet_.data.size());
+    handoff_response_packet_.size = EncodeMasterHandoffResponse(
+        config_.device_number, config_.device_name, false, handoff_response_packet_.data.data(),
+        handoff_response_packet_.data.size());
+  }
+
   // Remove devices that have not been seen within the timeout.
+  // Also evicts idle rate limit buckets and re-resolves auto_network addresses.
   void PruneLoop() {
+    auto next_network_refresh = std::chrono::steady_clock::now() + kNetworkRefreshInterval;
     while (running_) {
       std::this_thread::sleep_for(config_.device_prune_interval);
       if (!running_) {
         return;
       }
-      RunPrune(std::chrono::steady_clock::now());
+      const auto now = std::chrono::steady_clock::now();
+      RunPrune(now);
+      if (config_.auto_network && now >= next_network_refresh) {
+        ResolveNetwork(false);
+        next_network_refresh = now + kNetworkRefreshInterval;
+      }
     }
   }
 
   void RunPrune(std::chrono::steady_clock::time_point now) {
+    rate_limiter_.EvictIdle(now);
     std::vector<DeviceInfo> expired;
     {
       std::lock_guard<std::mutex> lock(devices_mutex_);
@@ -1391,7 +4006,7 @@ struct Session::Impl {
         if (entry.second.active &&
             now - entry.second.info.last_seen > config_.device_timeout) {
           entry.second.active = false;
-          expired.push_back(entry.second.info);
+          expired.push_back(DeviceSnapshot(entry.second));
         }
       }
 
@@ -1400,6 +4015,7 @@ struct Session::Impl {
       while (it != devices_.end()) {
         if (!it->second.active &&
             now - it->second.info.last_seen > remove_after) {
+          destinations_.Clear(it->first);
           it = devices_.erase(it);
         } else {
           ++it;
@@ -1422,7 +4038,7 @@ struct Session::Impl {
     }
   }
 
-  // Build and broadcast a beat packet.
+  // Patch and broadcast the beat packet.
   void SendBeatInternal() {
     if (!config_.send_beats) {
       return;
@@ -1442,35 +4058,31 @@ struct Session::Impl {
       last_sent_beat_ = snapshot.beat;
     }
 
-    std::vector<uint8_t> payload = BeatPayloadTemplate();
-    assert(payload.size() >= kOffsetBeatPayloadDeviceNumber2 + 1);
-    payload[kOffsetBeatPayloadDeviceNumber] = config_.device_number;
-
+    BeatFields fields;
     const uint32_t beat_interval = static_cast<uint32_t>(snapshot.beat_interval_ms);
     const uint32_t bar_interval = static_cast<uint32_t>(snapshot.bar_interval_ms);
-    WriteBe32(payload, kOffsetBeatPayloadInterval, beat_interval);
-    WriteBe32(payload, kOffsetBeatPayloadInterval2, SafeMul(beat_interval, 2));
-    WriteBe32(payload, kOffsetBeatPayloadInterval4, SafeMul(beat_interval, 4));
-    WriteBe32(payload, kOffsetBeatPayloadInterval8, SafeMul(beat_interval, 8));
+    fields.next_beat_ms = beat_interval;
+    fields.second_beat_ms = SafeMul(beat_interval, 2);
+    fields.fourth_beat_ms = SafeMul(beat_interval, 4);
+    fields.eighth_beat_ms = SafeMul(beat_interval, 8);
 
     const int beats_left = config_.beats_per_bar + 1 - snapshot.beat_within_bar;
-    const uint32_t next_bar = SafeMul(beat_interval, static_cast<uint32_t>(beats_left));
-    WriteBe32(payload, kOffsetBeatPayloadNextBar, next_bar);
-    WriteBe32(payload, kOffsetBeatPayloadNextBar2, next_bar + bar_interval);
-
-    WriteBe24(payload, kOffsetBeatPayloadPitch, pitch);
-    WriteBe16(payload, kOffsetBeatPayloadBpm,
-              static_cast<uint32_t>(std::lround(snapshot.tempo_bpm * 100)));
-    payload[kOffsetBeatPayloadBeatWithinBar] = snapshot.beat_within_bar;
-    payload[kOffsetBeatPayloadDeviceNumber2] = config_.device_number;
-
-    const auto packet = BuildPacket(PacketType::kBeat, config_.device_name, payload);
-    const auto addr = MakeSockaddr(config_.broadcast_address, kBeatPort);
-    const ssize_t result = beat_socket_.SendTo(packet, addr);
-    RecordSendResult("beat", result, packet.size());
+    fields.next_bar_ms = SafeMul(beat_interval, static_cast<uint32_t>(beats_left));
+    fields.second_bar_ms = fields.next_bar_ms + bar_interval;
+
+    fields.pitch = pitch;
+    fields.bpm = static_cast<uint32_t>(std::lround(snapshot.tempo_bpm * 100));
+    fields.beat_within_bar = snapshot.beat_within_bar;
+
+    std::lock_guard<std::mutex> lock(beat_packet_.mutex);
+    PatchBeat(fields, beat_packet_.data.data());
+    for (const auto& iface : interfaces_) {
+      SendPacket(iface->beat_socket, "beat", beat_packet_.data.data(), beat_packet_.size,
+                 iface->broadcast_addr(kBeatPort));
+    }
   }
 
-  // Build and broadcast a CDJ status packet.
+  // Patch and broadcast the CDJ status packet.
   void SendStatusInternal() {
     if (!config_.send_status) {
       return;
@@ -1487,39 +4099,36 @@ struct Session::Impl {
       handoff_to_device = handoff_to_device_;
     }
 
-    std::vector<uint8_t> payload = StatusPayloadTemplate();
-    assert(payload.size() >= kOffsetStatusPayloadPacketCounter + 4);
-    payload[kOffsetStatusPayloadDeviceNumber] = config_.device_number;
-    payload[kOffsetStatusPayloadDeviceNumber2] = config_.device_number;
-    payload[kOffsetStatusPayloadPlayingFlag] = snapshot_state.playing ? 1 : 0;
-    payload[kOffsetStatusPayloadDeviceNumber3] = config_.device_number;
-    payload[kOffsetStatusPayloadPlayState] = snapshot_state.playing ? 3 : 5;
-    payload[kOffsetStatusPayloadFlagByte] = static_cast<uint8_t>(0x84 +
-        (snapshot_state.playing ? 0x40 : 0) +
-        (snapshot_state.master ? 0x20 : 0) +
-        (snapshot_state.synced ? 0x10 : 0));
-    payload[kOffsetStatusPayloadPlayState2] = snapshot_state.playing ? 0x7a : 0x7e;
-    payload[kOffsetStatusPayloadPlayState3] = snapshot_state.playing ? 9 : 1;
-    payload[kOffsetStatusPayloadMasterFlag] = snapshot_state.master ? 1 : 0;
-    payload[kOffsetStatusPayloadMasterHandoff] =
-        snapshot_state.master ? handoff_to_device : 0xff;
-
-    WriteBe24(payload, kOffsetStatusPayloadPitch, snapshot_state.pitch);
-    WriteBe16(payload, kOffsetStatusPayloadBpm,
-              static_cast<uint32_t>(std::lround(snapshot_state.tempo_bpm * 100)));
-    WriteBe32(payload, kOffsetStatusPayloadBeatNumber, beat_snapshot.beat);
-    payload[kOffsetStatusPayloadBeatWithinBar] = beat_snapshot.beat_within_bar;
-    WriteBe32(payload, kOffsetStatusPayloadPacketCounter, packet_counter);
-
-    const auto packet =
-        BuildPacket(PacketType::kCdjStatus, config_.device_name, payload);
-    const auto addr = MakeSockaddr(config_.broadcast_address, kStatusPort);
-    const ssize_t result = status_socket_.SendTo(packet, addr);
-    RecordSendResult("status", result, packet.size());
+    StatusFields fields;
+    fields.is_playing = snapshot_state.playing;
+    fields.is_master = snapshot_state.master;
+    fields.is_synced = snapshot_state.synced;
+    fields.master_handoff_to = snapshot_state.master ? handoff_to_device : 0xff;
+    fields.pitch = snapshot_state.pitch;
+    fields.bpm = static_cast<uint32_t>(std::lround(snapshot_state.tempo_bpm * 100));
+    fields.beat = beat_snapshot.beat;
+    fields.beat_within_bar = beat_snapshot.beat_within_bar;
+    fields.packet_counter = packet_counter;
+
+    std::lock_guard<std::mutex> lock(status_packet_.mutex);
+    PatchStatus(fields, status_packet_.data.data());
+    for (const auto& iface : interfaces_) {
+      SendPacket(iface->status_socket, "status", status_packet_.data.data(),
+                 status_packet_.size, iface->broadcast_addr(kStatusPort));
+    }
+  }
+
+  // Refresh a device's control packet destination from its keep-alive.
+  // Called with devices_mutex_ held.
+  void UpdateDestinationLocked(const DeviceRecord& record) {
+    const uint8_t index = record.info.interface_index;
+    const uint32_t source_ip = index < interfaces_.size() ? interfaces_[index]->bind_ip : 0;
+    destinations_.Update(record.info.device_number, record.ip_address, index,
+                         config_.connect_control_sockets, source_ip);
   }
 
   // Update or create a device record from keep-alive packets.
-  void UpdateDeviceFromKeepAlive(const KeepAliveInfo& info) {
+  void UpdateDeviceFromKeepAlive(const KeepAliveInfo& info, const PacketMeta& meta) {
     const auto now = std::chrono::steady_clock::now();
     DeviceInfo snapshot;
     DeviceEventType event_type = DeviceEventType::kSeen;
@@ -1543,8 +4152,8 @@ struct Session::Impl {
         should_notify = true;
         event_type = DeviceEventType::kUpdated;
       }
-      if (!info.ip_address.empty() && record.info.ip_address != info.ip_address) {
-        record.info.ip_address = info.ip_address;
+      if (info.ip_address != 0 && record.ip_address != info.ip_address) {
+        record.ip_address = info.ip_address;
         should_notify = true;
         event_type = DeviceEventType::kUpdated;
       }
@@ -1554,6 +4163,9 @@ struct Session::Impl {
         event_type = DeviceEventType::kUpdated;
       }
       record.info.last_seen = now;
+      record.info.receive_time = meta.receive_time;
+      record.info.interface_index = meta.interface_index;
+      UpdateDestinationLocked(record);
       if (!record.active) {
         record.active = true;
         should_notify = true;
@@ -1563,7 +4175,9 @@ struct Session::Impl {
           event_type != DeviceEventType::kUpdated) {
         event_type = DeviceEventType::kUpdated;
       }
-      snapshot = record.info;
+      if (should_notify) {
+        snapshot = DeviceSnapshot(record);
+      }
     }
     if (should_notify) {
       DeviceCallback dev_cb_copy;
@@ -1590,9 +4204,25 @@ struct Session::Impl {
     }
   }
 
+  void HandleKeepAliveView(const KeepAliveView& view) {
+    KeepAliveViewCallback cb_copy;
+    {
+      std::lock_guard<std::mutex> lock(callback_mutex_);
+      cb_copy = keep_alive_view_cb_;
+    }
+    if (cb_copy) {
+      try {
+        cb_copy(view);
+      } catch (...) {
+        RecordCallbackException("KeepAliveViewCallback");
+      }
+    }
+  }
+
   // Update device last-seen from beat/status packets.
-  void UpdateDeviceSeen(uint8_t device_number, const std::string& name,
-                        const std::string& ip) {
+  void UpdateDeviceSeen(uint8_t device_number, std::string_view name,
+                        const PacketMeta& meta) {
+    const uint32_t ip = meta.source_ip;
     if (device_number == 0) {
       return;
     }
@@ -1614,12 +4244,14 @@ struct Session::Impl {
         should_notify = true;
         event_type = DeviceEventType::kUpdated;
       }
-      if (!ip.empty() && record.info.ip_address != ip) {
-        record.info.ip_address = ip;
+      if (ip != 0 && record.ip_address != ip) {
+        record.ip_address = ip;
         should_notify = true;
         event_type = DeviceEventType::kUpdated;
       }
       record.info.last_seen = now;
+      record.info.receive_time = meta.receive_time;
+      record.info.interface_index = meta.interface_index;
       if (!record.active) {
         record.active = true;
         should_notify = true;
@@ -1629,7 +4261,9 @@ struct Session::Impl {
           event_type != DeviceEventType::kUpdated) {
         event_type = DeviceEventType::kUpdated;
       }
-      snapshot = record.info;
+      if (should_notify) {
+        snapshot = DeviceSnapshot(record);
+      }
     }
     if (should_notify) {
       DeviceCallback dev_cb_copy;
@@ -1656,52 +4290,42 @@ struct Session::Impl {
     }
   }
 
-  // Find the IP address for a device number, if known.
-  std::optional<std::string> LookupDeviceIp(uint8_t device_number) const {
-    std::lock_guard<std::mutex> lock(devices_mutex_);
-    auto it = devices_.find(device_number);
-    if (it == devices_.end() || it->second.info.ip_address.empty()) {
-      return std::nullopt;
+  // Send a port 50001 packet to a device: unicast to its cached address out
+  // of the interface it was last seen on, or broadcast on every interface if
+  // it is unknown.
+  void SendToDevice(uint8_t device_number, const char* packet_type, const uint8_t* data,
+                    size_t size) {
+    DestinationCache::Destination dest;
+    if (destinations_.Load(device_number, &dest) && dest.interface_index < interfaces_.size()) {
+      ssize_t result = 0;
+      if (destinations_.SendConnected(device_number, data, size, &result)) {
+        RecordSendResult(packet_type, result, size);
+        return;
+      }
+      SendPacket(interfaces_[dest.interface_index]->beat_socket, packet_type, data, size,
+                 dest.addr);
+      return;
+    }
+    metrics_.broadcast_fallbacks.fetch_add(1);
+    for (const auto& iface : interfaces_) {
+      SendPacket(iface->beat_socket, packet_type, data, size, iface->broadcast_addr(kBeatPort));
     }
-    return it->second.info.ip_address;
   }
 
-  // Build and send a sync control packet to a device.
+  // Patch and send the sync control packet to a device.
   void SendSyncControlInternal(uint8_t target_device, SyncCommand command) {
-    std::vector<uint8_t> payload(kControlPayloadSize, 0x00);
-    payload[0x00] = 0x01;
-    payload[0x01] = 0x00;
-    payload[kControlPayloadDeviceNumber] = config_.device_number;
-    payload[0x03] = 0x00;
-    payload[0x04] = 0x08;
-    payload[kControlPayloadSender] = config_.device_number;
-    payload[kControlPayloadCommand] = static_cast<uint8_t>(command);
-
-    const auto packet = BuildPacket(PacketType::kSyncControl, config_.device_name, payload);
-    const auto target_ip = LookupDeviceIp(target_device);
-    const auto addr = MakeSockaddr(target_ip.value_or(config_.broadcast_address),
-                                   kBeatPort);
-    const ssize_t result = beat_socket_.SendTo(packet, addr);
-    RecordSendResult("sync_control", result, packet.size());
+    std::lock_guard<std::mutex> lock(sync_control_packet_.mutex);
+    ControlLayout::Command::Write(sync_control_packet_.data.data(),
+                                  static_cast<uint8_t>(command));
+    SendToDevice(target_device, "sync_control", sync_control_packet_.data.data(),
+                 sync_control_packet_.size);
   }
 
   // Send a master handoff request to the current tempo master.
   void SendMasterHandoffRequestInternal(uint8_t target_device) {
-    std::vector<uint8_t> payload(kHandoffRequestPayloadSize, 0x00);
-    payload[0x00] = 0x01;
-    payload[0x01] = 0x00;
-    payload[kControlPayloadDeviceNumber] = config_.device_number;
-    payload[0x03] = 0x00;
-    payload[0x04] = 0x04;
-    payload[kControlPayloadSender] = config_.device_number;
-
-    const auto packet =
-        BuildPacket(PacketType::kMasterHandoffRequest, config_.device_name, payload);
-    const auto target_ip = LookupDeviceIp(target_device);
-    const auto addr = MakeSockaddr(target_ip.value_or(config_.broadcast_address),
-                                   kBeatPort);
-    const ssize_t result = beat_socket_.SendTo(packet, addr);
-    RecordSendResult("master_handoff_request", result, packet.size());
+    std::lock_guard<std::mutex> lock(handoff_request_packet_.mutex);
+    SendToDevice(target_device, "master_handoff_request", handoff_request_packet_.data.data(),
+                 handoff_request_packet_.size);
   }
 
   // Retry master handoff requests with timeout and retry budget.
@@ -1742,22 +4366,10 @@ struct Session::Impl {
   }
 
   void SendMasterHandoffResponse(uint8_t target_device, bool accepted) {
-    std::vector<uint8_t> payload(kControlPayloadSize, 0x00);
-    payload[0x00] = 0x01;
-    payload[0x01] = 0x00;
-    payload[kControlPayloadDeviceNumber] = config_.device_number;
-    payload[0x03] = 0x00;
-    payload[0x04] = 0x08;
-    payload[kControlPayloadSender] = config_.device_number;
-    payload[kControlPayloadCommand] = accepted ? 0x01 : 0x00;
-
-    const auto packet =
-        BuildPacket(PacketType::kMasterHandoffResponse, config_.device_name, payload);
-    const auto target_ip = LookupDeviceIp(target_device);
-    const auto addr = MakeSockaddr(target_ip.value_or(config_.broadcast_address),
-                                   kBeatPort);
-    const ssize_t result = beat_socket_.SendTo(packet, addr);
-    RecordSendResult("master_handoff_response", result, packet.size());
+    std::lock_guard<std::mutex> lock(handoff_response_packet_.mutex);
+    ControlLayout::Command::Write(handoff_response_packet_.data.data(), accepted ? 0x01 : 0x00);
+    SendToDevice(target_device, "master_handoff_response", handoff_response_packet_.data.data(),
+                 handoff_response_packet_.size);
   }
 
   // Respond to an incoming sync control packet.
@@ -1849,17 +4461,54 @@ struct Session::Impl {
 
   Config config_;
   std::atomic<bool> running_{false};
-  UdpSocket beat_socket_;
-  UdpSocket status_socket_;
-  UdpSocket device_socket_;
-  UdpSocket announce_socket_;
+  // Set while Start() has threads that Stop() must join. Unlike running_, it
+  // stays set when the threads exit on their own (replay file exhausted).
+  std::atomic<bool> started_{false};
+  // One entry per resolved Config::interfaces entry, in order; the index is
+  // the interface_index reported with packets and devices.
+  std::vector<std::unique_ptr<NetInterface>> interfaces_;
+  mutable std::mutex network_mutex_;
+  // Guards opening and closing the UDP sockets against GetMetrics().
+  mutable std::mutex sockets_mutex_;
+  SendBuffer beat_packet_;
+  SendBuffer status_packet_;
+  SendBuffer sync_control_packet_;
+  SendBuffer handoff_request_packet_;
+  SendBuffer handoff_response_packet_;
+  DestinationCache destinations_;
+  // Port 50001 runs on beat_lane_ when Config::beat_lane is set; everything
+  // else is received on recv_lane_.
+  RecvLane recv_lane_;
+  RecvLane beat_lane_;
+#ifdef __linux__
+  static constexpr size_t kSnifferTag = static_cast<size_t>(-2);
+  PacketSniffer sniffer_;
+#endif
+#ifdef PROLINK_HAVE_IO_URING
+  std::unique_ptr<IoUringReactor> io_uring_;
+#endif
 
   BeatCallback beat_cb_;
   StatusCallback status_cb_;
+  uint32_t status_fields_ = kStatusFieldsAll;
+  BeatViewCallback beat_view_cb_;
+  StatusViewCallback status_view_cb_;
+  KeepAliveViewCallback keep_alive_view_cb_;
+  RawPacketCallback raw_packet_cb_;
+  // Bumped under callback_mutex_ whenever raw_packet_cb_ changes.
+  std::atomic<uint64_t> raw_packet_cb_generation_{0};
+  PositionCallback position_cb_;
+  PositionSlots positions_;
+  MixerStatusCallback mixer_status_cb_;
+  OnAirCallback on_air_cb_;
+  FaderStartCallback fader_start_cb_;
+  MixerChannelTable mixer_channels_;
   DeviceCallback device_cb_;
   DeviceEventCallback device_event_cb_;
   std::string start_error_;
   SessionMetricsAtomic metrics_;
+  RateLimiter rate_limiter_;
+  DuplicateFilter duplicate_filter_;
 
   mutable std::mutex callback_mutex_;
   mutable std::mutex state_mutex_;
@@ -1884,9 +4533,11 @@ struct Session::Impl {
   mutable std::mutex capture_mutex_;
   std::ofstream capture_stream_;
   std::ifstream replay_stream_;
+  // Format version of replay_stream_; 0 for a headerless legacy capture.
+  uint32_t replay_version_ = 0;
   bool replay_mode_ = false;
+  bool monitor_mode_ = false;
 
-  std::thread recv_thread_;
   std::thread beat_thread_;
   std::thread status_thread_;
   std::thread announce_thread_;
@@ -1901,12 +4552,44 @@ bool Session::Start() { return impl_->Start(); }
 void Session::Stop() { impl_->Stop(); }
 
 void Session::SetBeatCallback(BeatCallback cb) { impl_->SetBeatCallback(std::move(cb)); }
-void Session::SetStatusCallback(StatusCallback cb) { impl_->SetStatusCallback(std::move(cb)); }
+void Session::SetStatusCallback(StatusCallback cb, uint32_t fields) {
+  impl_->SetStatusCallback(std::move(cb), fields);
+}
 void Session::SetDeviceCallback(DeviceCallback cb) { impl_->SetDeviceCallback(std::move(cb)); }
 void Session::SetDeviceEventCallback(DeviceEventCallback cb) {
   impl_->SetDeviceEventCallback(std::move(cb));
 }
 
+void Session::SetBeatViewCallback(BeatViewCallback cb) {
+  impl_->SetBeatViewCallback(std::move(cb));
+}
+
+void Session::SetStatusViewCallback(StatusViewCallback cb) {
+  impl_->SetStatusViewCallback(std::move(cb));
+}
+
+void Session::SetKeepAliveViewCallback(KeepAliveViewCallback cb) {
+  impl_->SetKeepAliveViewCallback(std::move(cb));
+}
+
+void Session::SetPositionCallback(PositionCallback cb) {
+  impl_->SetPositionCallback(std::move(cb));
+}
+
+void Session::SetMixerStatusCallback(MixerStatusCallback cb) {
+  impl_->SetMixerStatusCallback(std::move(cb));
+}
+
+void Session::SetOnAirCallback(OnAirCallback cb) { impl_->SetOnAirCallback(std::move(cb)); }
+
+void Session::SetFaderStartCallback(FaderStartCallback cb) {
+  impl_->SetFaderStartCallback(std::move(cb));
+}
+
+void Session::SetRawPacketCallback(RawPacketCallback cb) {
+  impl_->SetRawPacketCallback(std::move(cb));
+}
+
 void Session::SetTempo(double bpm) { impl_->SetTempo(bpm); }
 void Session::SetPitchPercent(double percent) { impl_->SetPitchPercent(percent); }
 void Session::SetPlaying(bool playing) { impl_->SetPlaying(playing); }
@@ -1930,6 +4613,16 @@ std::optional<StatusInfo> Session::GetTempoMaster() const {
   return impl_->GetTempoMaster();
 }
 
+std::optional<PositionInfo> Session::GetLatestPosition(uint8_t device_number) const {
+  return impl_->GetLatestPosition(device_number);
+}
+
+std::optional<bool> Session::IsOnAir(uint8_t channel) const { return impl_->IsOnAir(channel); }
+
+std::optional<FaderStartCommand> Session::GetFaderStart(uint8_t channel) const {
+  return impl_->GetFaderStart(channel);
+}
+
 std::vector<DeviceInfo> Session::GetDevices() const {
   return impl_->GetDevices();
 }
@@ -1938,6 +4631,10 @@ std::string Session::GetLastError() const {
   return impl_->GetLastError();
 }
 
+std::vector<NetworkInterfaceInfo> Session::GetInterfaces() const {
+  return impl_->GetInterfaces();
+}
+
 SessionMetrics Session::GetMetrics() const {
   return impl_->GetMetrics();
 }
@@ -1945,6 +4642,14 @@ SessionMetrics Session::GetMetrics() const {
 #ifdef PROLINK_TESTING
 namespace test {
 
+// Run a codec encoder into a vector trimmed to the packet it wrote.
+template <typename Encode>
+std::vector<uint8_t> EncodePacket(Encode encode) {
+  std::vector<uint8_t> packet(kMaxEncodedPacketSize);
+  packet.resize(encode(packet.data(), packet.size()));
+  return packet;
+}
+
 struct BeatClockTester::Impl {
   explicit Impl(int beats_per_bar) : clock(beats_per_bar) {}
   BeatClock clock;
@@ -1983,41 +4688,24 @@ BeatClockSnapshot BeatClockTester::Snapshot(std::chrono::steady_clock::time_poin
 std::vector<uint8_t> BuildSyncControlPacket(uint8_t device_number,
                                             const std::string& device_name,
                                             SyncCommand command) {
-  std::vector<uint8_t> payload(kControlPayloadSize, 0x00);
-  payload[0x00] = 0x01;
-  payload[0x01] = 0x00;
-  payload[kControlPayloadDeviceNumber] = device_number;
-  payload[0x03] = 0x00;
-  payload[0x04] = 0x08;
-  payload[kControlPayloadSender] = device_number;
-  payload[kControlPayloadCommand] = static_cast<uint8_t>(command);
-  return BuildPacket(PacketType::kSyncControl, device_name, payload);
+  return EncodePacket([&](uint8_t* out, size_t capacity) {
+    return EncodeSyncControl(device_number, device_name, command, out, capacity);
+  });
 }
 
 std::vector<uint8_t> BuildMasterHandoffRequestPacket(uint8_t device_number,
                                                      const std::string& device_name) {
-  std::vector<uint8_t> payload(kHandoffRequestPayloadSize, 0x00);
-  payload[0x00] = 0x01;
-  payload[0x01] = 0x00;
-  payload[kControlPayloadDeviceNumber] = device_number;
-  payload[0x03] = 0x00;
-  payload[0x04] = 0x04;
-  payload[kControlPayloadSender] = device_number;
-  return BuildPacket(PacketType::kMasterHandoffRequest, device_name, payload);
+  return EncodePacket([&](uint8_t* out, size_t capacity) {
+    return EncodeMasterHandoffRequest(device_number, device_name, out, capacity);
+  });
 }
 
 std::vector<uint8_t> BuildMasterHandoffResponsePacket(uint8_t device_number,
                                                       const std::string& device_name,
                                                       bool accepted) {
-  std::vector<uint8_t> payload(kControlPayloadSize, 0x00);
-  payload[0x00] = 0x01;
-  payload[0x01] = 0x00;
-  payload[kControlPayloadDeviceNumber] = device_number;
-  payload[0x03] = 0x00;
-  payload[0x04] = 0x08;
-  payload[kControlPayloadSender] = device_number;
-  payload[kControlPayloadCommand] = accepted ? 0x01 : 0x00;
-  return BuildPacket(PacketType::kMasterHandoffResponse, device_name, payload);
+  return EncodePacket([&](uint8_t* out, size_t capacity) {
+    return EncodeMasterHandoffResponse(device_number, device_name, accepted, out, capacity);
+  });
 }
 
 std::vector<uint8_t> BuildBeatPacket(uint8_t device_number,
@@ -2027,16 +4715,16 @@ std::vector<uint8_t> BuildBeatPacket(uint8_t device_number,
                                      uint8_t beat_within_bar,
                                      uint32_t next_beat_ms,
                                      uint32_t next_bar_ms) {
-  std::vector<uint8_t> payload = BeatPayloadTemplate();
-  assert(payload.size() >= kOffsetBeatPayloadDeviceNumber2 + 1);
-  payload[kOffsetBeatPayloadDeviceNumber] = device_number;
-  payload[kOffsetBeatPayloadDeviceNumber2] = device_number;
-  WriteBe32(payload, kOffsetBeatPayloadInterval, next_beat_ms);
-  WriteBe32(payload, kOffsetBeatPayloadNextBar, next_bar_ms);
-  WriteBe24(payload, kOffsetBeatPayloadPitch, pitch);
-  WriteBe16(payload, kOffsetBeatPayloadBpm, bpm);
-  payload[kOffsetBeatPayloadBeatWithinBar] = beat_within_bar;
-  return BuildPacket(PacketType::kBeat, device_name, payload);
+  BeatFields fields;
+  fields.device_number = device_number;
+  fields.device_name = device_name;
+  fields.bpm = bpm;
+  fields.pitch = pitch;
+  fields.beat_within_bar = beat_within_bar;
+  fields.next_beat_ms = next_beat_ms;
+  fields.next_bar_ms = next_bar_ms;
+  return EncodePacket(
+      [&](uint8_t* out, size_t capacity) { return EncodeBeat(fields, out, capacity); });
 }
 
 std::vector<uint8_t> BuildStatusPacket(uint8_t device_number,
@@ -2049,26 +4737,72 @@ std::vector<uint8_t> BuildStatusPacket(uint8_t device_number,
                                        bool is_synced,
                                        bool is_playing,
                                        uint8_t master_handoff_to) {
-  std::vector<uint8_t> payload = StatusPayloadTemplate();
-  assert(payload.size() >= kOffsetStatusPayloadPacketCounter + 4);
-  payload[kOffsetStatusPayloadDeviceNumber] = device_number;
-  uint8_t flags = 0;
-  if (is_master) {
-    flags |= kStatusFlagMaster;
-  }
-  if (is_synced) {
-    flags |= kStatusFlagSynced;
-  }
-  if (is_playing) {
-    flags |= kStatusFlagPlaying;
-  }
-  payload[kOffsetStatusPayloadFlagByte] = flags;
-  payload[kOffsetStatusPayloadMasterHandoff] = master_handoff_to;
-  WriteBe24(payload, kOffsetStatusPayloadPitch, pitch);
-  WriteBe16(payload, kOffsetStatusPayloadBpm, bpm);
-  WriteBe32(payload, kOffsetStatusPayloadBeatNumber, beat_number);
-  payload[kOffsetStatusPayloadBeatWithinBar] = beat_within_bar;
-  return BuildPacket(PacketType::kCdjStatus, device_name, payload);
+  StatusFields fields;
+  fields.device_number = device_number;
+  fields.device_name = device_name;
+  fields.bpm = bpm;
+  fields.pitch = pitch;
+  fields.beat = beat_number;
+  fields.beat_within_bar = beat_within_bar;
+  fields.is_master = is_master;
+  fields.is_synced = is_synced;
+  fields.is_playing = is_playing;
+  fields.master_handoff_to = master_handoff_to;
+  std::vector<uint8_t> packet = EncodePacket(
+      [&](uint8_t* out, size_t capacity) { return EncodeStatus(fields, out, capacity); });
+  // Keep only the requested flag bits so tests see exactly what they asked for.
+  StatusLayout::Flags::Write(packet.data(), (is_master ? kStatusFlagMaster : 0) |
+                                                (is_synced ? kStatusFlagSynced : 0) |
+                                                (is_playing ? kStatusFlagPlaying : 0));
+  return packet;
+}
+
+std::vector<uint8_t> BuildPositionPacket(uint8_t device_number,
+                                         const std::string& device_name,
+                                         uint32_t track_length_s,
+                                         uint32_t playhead_ms,
+                                         int32_t pitch,
+                                         uint32_t bpm_x10) {
+  PositionInfo info;
+  info.device_number = device_number;
+  info.track_length_s = track_length_s;
+  info.playhead_ms = playhead_ms;
+  info.pitch = pitch;
+  info.bpm = SafeMul(bpm_x10, 10);
+  return EncodePacket([&](uint8_t* out, size_t capacity) {
+    return EncodePosition(info, device_name, out, capacity);
+  });
+}
+
+std::vector<uint8_t> BuildMixerStatusPacket(uint8_t device_number,
+                                            const std::string& device_name,
+                                            uint32_t bpm,
+                                            uint8_t beat_within_bar,
+                                            bool is_master) {
+  return EncodePacket([&](uint8_t* out, size_t capacity) {
+    return EncodeMixerStatus(device_number, device_name, bpm, beat_within_bar, is_master, out,
+                             capacity);
+  });
+}
+
+std::vector<uint8_t> BuildOnAirPacket(uint8_t device_number,
+                                      const std::array<bool, kMixerChannelCount>& on_air) {
+  OnAirInfo info;
+  info.device_number = device_number;
+  info.on_air = on_air;
+  return EncodePacket([&](uint8_t* out, size_t capacity) {
+    return EncodeOnAir(info, "DJM-900nexus", out, capacity);
+  });
+}
+
+std::vector<uint8_t> BuildFaderStartPacket(
+    uint8_t device_number, const std::array<FaderStartCommand, kMixerChannelCount>& commands) {
+  FaderStartInfo info;
+  info.device_number = device_number;
+  info.commands = commands;
+  return EncodePacket([&](uint8_t* out, size_t capacity) {
+    return EncodeFaderStart(info, "DJM-900nexus", out, capacity);
+  });
 }
 
 std::vector<uint8_t> BuildKeepAlivePacket(uint8_t device_number,
@@ -2076,39 +4810,14 @@ std::vector<uint8_t> BuildKeepAlivePacket(uint8_t device_number,
                                           const std::string& device_name,
                                           const std::array<uint8_t, 6>& mac_address,
                                           const std::string& ip_address) {
-  std::array<uint8_t, 4> ip_bytes{};
-  if (!ip_address.empty()) {
-    in_addr addr{};
-    if (inet_pton(AF_INET, ip_address.c_str(), &addr) == 1) {
-      std::memcpy(ip_bytes.data(), &addr, ip_bytes.size());
-    }
-  }
-
-  std::array<uint8_t, kDeviceNameLength> name_bytes{};
-  const size_t copy_len = std::min(device_name.size(), name_bytes.size());
-  std::memcpy(name_bytes.data(), device_name.data(), copy_len);
-
-  std::vector<uint8_t> packet;
-  packet.reserve(kKeepAlivePacketSize);
-  packet.insert(packet.end(), kProlinkHeader, kProlinkHeader + kHeaderSize);
-  packet.push_back(static_cast<uint8_t>(PacketType::kDeviceKeepAlive));
-  packet.push_back(0x00);
-  packet.insert(packet.end(), name_bytes.begin(), name_bytes.end());
-  packet.push_back(0x01);
-  packet.push_back(0x02);
-  packet.push_back(0x00);
-  packet.push_back(static_cast<uint8_t>(kKeepAlivePacketSize));
-  packet.push_back(device_number);
-  packet.push_back(device_type);
-  packet.insert(packet.end(), mac_address.begin(), mac_address.end());
-  packet.insert(packet.end(), ip_bytes.begin(), ip_bytes.end());
-  packet.push_back(0x01);
-  packet.push_back(0x00);
-  packet.push_back(0x00);
-  packet.push_back(0x00);
-  packet.push_back(device_type);
-  packet.push_back(0x00);
-  return packet;
+  KeepAliveFields fields;
+  fields.device_number = device_number;
+  fields.device_type = device_type;
+  fields.device_name = device_name;
+  fields.mac_address = mac_address;
+  inet_pton(AF_INET, ip_address.c_str(), &fields.ip_address);
+  return EncodePacket(
+      [&](uint8_t* out, size_t capacity) { return EncodeKeepAlive(fields, out, capacity); });
 }
 
 bool ParseBeatPacket(const std::vector<uint8_t>& data, BeatInfo* out) {
@@ -2119,6 +4828,19 @@ bool ParseStatusPacket(const std::vector<uint8_t>& data, StatusInfo* out) {
   return ParseStatus(data.data(), data.size(), out);
 }
 
+bool ParsePositionPacket(const std::vector<uint8_t>& data, PositionInfo* out) {
+  return DecodePosition(data.data(), data.size(), out);
+}
+
+bool ParseMixerStatusPacket(const std::vector<uint8_t>& data, MixerStatusInfo* out) {
+  const MixerStatusView view(data.data(), data.size());
+  if (!out || !view.valid()) {
+    return false;
+  }
+  *out = Materialize(view);
+  return true;
+}
+
 bool ParseKeepAlivePacket(const std::vector<uint8_t>& data, DeviceInfo* out) {
   if (!out) {
     return false;
@@ -2130,9 +4852,29 @@ bool ParseKeepAlivePacket(const std::vector<uint8_t>& data, DeviceInfo* out) {
   out->device_number = info.device_number;
   out->device_type = info.device_type;
   out->device_name = info.device_name;
-  out->ip_address = info.ip_address;
+  out->ip_address = Ipv4ToString(info.ip_address);
   out->mac_address = info.mac_address;
   out->last_seen = std::chrono::steady_clock::now();
+  out->receive_time = out->last_seen;
+  return true;
+}
+
+bool ClassifyWith(ClassifierIsa isa, const std::vector<std::vector<uint8_t>>& datagrams,
+                  std::vector<ClassifiedDatagram>* out, uint16_t port) {
+  const ClassifyBatchFn classify = ClassifierFor(isa);
+  if (!classify || !out) {
+    return false;
+  }
+  std::vector<const uint8_t*> data;
+  std::vector<size_t> lengths;
+  for (const auto& datagram : datagrams) {
+    data.push_back(datagram.data());
+    lengths.push_back(datagram.size());
+  }
+  std::vector<DatagramClass> classes(datagrams.size());
+  classify(data.data(), lengths.data(), datagrams.size(), port, classes.data());
+  out->resize(datagrams.size());
+  out->resize(CompactAccepted(classes.data(), classes.size(), 0, out->data()));
   return true;
 }
 
@@ -2146,9 +4888,11 @@ void InjectKeepAlive(Session& session,
   info.device_number = device_number;
   info.device_type = device_type;
   info.device_name = device_name;
-  info.ip_address = ip_address;
+  inet_pton(AF_INET, ip_address.c_str(), &info.ip_address);
   info.mac_address = mac_address;
-  session.impl_->UpdateDeviceFromKeepAlive(info);
+  PacketMeta meta;
+  meta.receive_time = std::chrono::steady_clock::now();
+  session.impl_->UpdateDeviceFromKeepAlive(info, meta);
 }
 
 void SetDeviceLastSeen(Session& session,
@@ -0,0 +1,242 @@
+// Tests for the standalone codec: encode into caller buffers and decode back.
+#include "prolink/codec.h"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+namespace {
+
+using Buffer = std::array<uint8_t, prolink::kMaxEncodedPacketSize>;
+
+}  // namespace
+
+TEST(CodecTest, BeatRoundTrip) {
+  prolink::BeatFields fields;
+  fields.device_number = 3;
+  fields.device_name = "CDJ-3000";
+  fields.bpm = 12850;
+  fields.beat_within_bar = 2;
+  fields.next_beat_ms = 466;
+  fields.next_bar_ms = 1400;
+
+  Buffer buffer{};
+  const size_t size = prolink::EncodeBeat(fields, buffer.data(), buffer.size());
+  ASSERT_EQ(size, 0x60u);
+
+  const prolink::BeatView view(buffer.data(), size);
+  ASSERT_TRUE(view.valid());
+  EXPECT_EQ(view.device_number(), 3);
+  EXPECT_EQ(view.device_name(), "CDJ-3000");
+  EXPECT_EQ(view.bpm(), 12850u);
+  EXPECT_EQ(view.pitch(), prolink::kNeutralPitch);
+  EXPECT_EQ(view.beat_within_bar(), 2);
+  EXPECT_EQ(view.next_beat_ms(), 466u);
+  EXPECT_EQ(view.next_bar_ms(), 1400u);
+}
+
+TEST(CodecTest, StatusRoundTrip) {
+  prolink::StatusFields fields;
+  fields.device_number = 2;
+  fields.device_name = "CDJ-2000NXS2";
+  fields.bpm = 12000;
+  fields.beat = 33;
+  fields.beat_within_bar = 1;
+  fields.is_playing = true;
+  fields.is_master = true;
+  fields.master_handoff_to = 4;
+  fields.packet_counter = 77;
+
+  Buffer buffer{};
+  const size_t size = prolink::EncodeStatus(fields, buffer.data(), buffer.size());
+  ASSERT_GT(size, 0u);
+
+  const prolink::StatusView view(buffer.data(), size);
+  ASSERT_TRUE(view.valid());
+  EXPECT_EQ(view.device_number(), 2);
+  EXPECT_EQ(view.device_name(), "CDJ-2000NXS2");
+  EXPECT_EQ(view.bpm(), std::optional<uint32_t>(12000));
+  EXPECT_EQ(view.beat(), std::optional<uint32_t>(33));
+  EXPECT_TRUE(view.is_playing());
+  EXPECT_TRUE(view.is_master());
+  EXPECT_FALSE(view.is_synced());
+  EXPECT_EQ(view.master_handoff_to(), 4);
+  EXPECT_EQ(view.play_state(), prolink::PlayState::kPlaying);
+  EXPECT_EQ(view.track_source_player(), 2);
+  EXPECT_EQ(view.packet_counter(), std::optional<uint32_t>(77));
+
+  fields.bpm = prolink::kNoBpm;
+  fields.beat = prolink::kNoBeatNumber;
+  ASSERT_EQ(prolink::EncodeStatus(fields, buffer.data(), buffer.size()), size);
+  EXPECT_FALSE(view.bpm().has_value());
+  EXPECT_FALSE(view.beat().has_value());
+}
+
+TEST(CodecTest, KeepAliveRoundTrip) {
+  prolink::KeepAliveFields fields;
+  fields.device_number = 5;
+  fields.device_type = 0x03;
+  fields.device_name = "DJM-900nexus";
+  fields.mac_address = {0x00, 0x11, 0x22, 0x33, 0x44, 0x55};
+  const std::array<uint8_t, 4> ip = {192, 168, 1, 50};
+  std::memcpy(&fields.ip_address, ip.data(), ip.size());
+
+  Buffer buffer{};
+  const size_t size = prolink::EncodeKeepAlive(fields, buffer.data(), buffer.size());
+  ASSERT_EQ(size, 0x36u);
+
+  const prolink::KeepAliveView view(buffer.data(), size);
+  ASSERT_TRUE(view.valid());
+  EXPECT_EQ(view.device_number(), 5);
+  EXPECT_EQ(view.device_type(), 0x03);
+  EXPECT_EQ(view.device_name(), "DJM-900nexus");
+  EXPECT_EQ(view.mac_address(), fields.mac_address);
+  EXPECT_EQ(view.ip_address(), fields.ip_address);
+}
+
+TEST(CodecTest, PositionRoundTrip) {
+  prolink::PositionInfo info;
+  info.device_number = 1;
+  info.track_length_s = 245;
+  info.playhead_ms = 61234;
+  info.pitch = -325;
+  info.bpm = 12410;
+
+  Buffer buffer{};
+  const size_t size = prolink::EncodePosition(info, "CDJ-3000", buffer.data(), buffer.size());
+  ASSERT_EQ(size, 0x3cu);
+
+  prolink::PositionInfo decoded;
+  ASSERT_TRUE(prolink::DecodePosition(buffer.data(), size, &decoded));
+  EXPECT_EQ(decoded.device_number, 1);
+  EXPECT_EQ(decoded.track_length_s, 245u);
+  EXPECT_EQ(decoded.playhead_ms, 61234u);
+  EXPECT_EQ(decoded.pitch, -325);
+  EXPECT_EQ(decoded.bpm, 12410u);
+  EXPECT_FALSE(prolink::DecodePosition(buffer.data(), size - 1, &decoded));
+}
+
+TEST(CodecTest, MixerChannelRoundTrip) {
+  prolink::OnAirInfo on_air;
+  on_air.device_number = 0x21;
+  on_air.on_air = {true, false, true, false};
+  Buffer buffer{};
+  size_t size = prolink::EncodeOnAir(on_air, "DJM-900nexus", buffer.data(), buffer.size());
+  ASSERT_GT(size, 0u);
+  prolink::OnAirInfo decoded_on_air;
+  ASSERT_TRUE(prolink::DecodeOnAir(buffer.data(), size, &decoded_on_air));
+  EXPECT_EQ(decoded_on_air.device_number, 0x21);
+  EXPECT_EQ(decoded_on_air.on_air, on_air.on_air);
+  EXPECT_FALSE(prolink::DecodeFaderStart(buffer.data(), size, nullptr));
+
+  prolink::FaderStartInfo fader;
+  fader.device_number = 0x21;
+  fader.commands = {prolink::FaderStartCommand::kStart, prolink::FaderStartCommand::kNoChange,
+                    prolink::FaderStartCommand::kStop, prolink::FaderStartCommand::kNoChange};
+  size = prolink::EncodeFaderStart(fader, "DJM-900nexus", buffer.data(), buffer.size());
+  ASSERT_GT(size, 0u);
+  prolink::FaderStartInfo decoded_fader;
+  ASSERT_TRUE(prolink::DecodeFaderStart(buffer.data(), size, &decoded_fader));
+  EXPECT_EQ(decoded_fader.commands, fader.commands);
+  EXPECT_FALSE(prolink::DecodeOnAir(buffer.data(), size, &decoded_on_air));
+}
+
+TEST(CodecTest, MixerStatusRoundTrip) {
+  Buffer buffer{};
+  const size_t size = prolink::EncodeMixerStatus(0x21, "DJM-900nexus", 12600, 3, true,
+                                                 buffer.data(), buffer.size());
+  ASSERT_EQ(size, 0x38u);
+
+  const prolink::MixerStatusView view(buffer.data(), size);
+  ASSERT_TRUE(view.valid());
+  EXPECT_EQ(view.device_number(), 0x21);
+  EXPECT_EQ(view.bpm(), std::optional<uint32_t>(12600));
+  EXPECT_EQ(view.beat_within_bar(), 3);
+  EXPECT_TRUE(view.is_master());
+}
+
+TEST(CodecTest, PatchMatchesFreshEncode) {
+  prolink::BeatFields beat;
+  beat.device_number = 4;
+  beat.device_name = "prolink-cpp";
+  Buffer patched{};
+  const size_t beat_size = prolink::EncodeBeat(beat, patched.data(), patched.size());
+  beat.bpm = 13000;
+  beat.pitch = prolink::kNeutralPitch + 0x1000;
+  beat.beat_within_bar = 4;
+  beat.next_beat_ms = 461;
+  beat.second_bar_ms = 3000;
+  prolink::PatchBeat(beat, patched.data());
+  Buffer fresh{};
+  ASSERT_EQ(prolink::EncodeBeat(beat, fresh.data(), fresh.size()), beat_size);
+  EXPECT_EQ(patched, fresh);
+
+  prolink::StatusFields status;
+  status.device_number = 4;
+  status.device_name = "prolink-cpp";
+  patched = {};
+  const size_t status_size = prolink::EncodeStatus(status, patched.data(), patched.size());
+  status.bpm = 12500;
+  status.beat = 128;
+  status.is_playing = true;
+  status.is_synced = true;
+  status.packet_counter = 9;
+  prolink::PatchStatus(status, patched.data());
+  fresh = {};
+  ASSERT_EQ(prolink::EncodeStatus(status, fresh.data(), fresh.size()), status_size);
+  EXPECT_EQ(patched, fresh);
+}
+
+TEST(CodecTest, EncodersRejectShortBuffers) {
+  Buffer buffer{};
+  prolink::BeatFields beat;
+  EXPECT_EQ(prolink::EncodeBeat(beat, buffer.data(), 0x5f), 0u);
+  prolink::StatusFields status;
+  EXPECT_EQ(prolink::EncodeStatus(status, buffer.data(), 0x40), 0u);
+  prolink::KeepAliveFields keep_alive;
+  EXPECT_EQ(prolink::EncodeKeepAlive(keep_alive, buffer.data(), 0x35), 0u);
+  EXPECT_EQ(prolink::EncodeSyncControl(1, "CDJ", prolink::SyncCommand::kBecomeMaster,
+                                       buffer.data(), 0x10),
+            0u);
+  EXPECT_EQ(prolink::EncodeBeat(beat, nullptr, buffer.size()), 0u);
+  // Nothing was written on failure.
+  for (const uint8_t byte : buffer) {
+    ASSERT_EQ(byte, 0);
+  }
+}
+
+TEST(CodecTest, ClassifyAndBatchParseEncodedPackets) {
+  Buffer beat_buffer{};
+  Buffer status_buffer{};
+  prolink::BeatFields beat;
+  beat.device_number = 1;
+  beat.bpm = 12800;
+  prolink::StatusFields status;
+  status.device_number = 2;
+  status.bpm = 12000;
+  status.beat = 9;
+  const size_t beat_size = prolink::EncodeBeat(beat, beat_buffer.data(), beat_buffer.size());
+  const size_t status_size =
+      prolink::EncodeStatus(status, status_buffer.data(), status_buffer.size());
+
+  const uint8_t* data[] = {beat_buffer.data(), status_buffer.data()};
+  const size_t lengths[] = {beat_size, status_size};
+  prolink::ClassifiedDatagram classified[2];
+  ASSERT_EQ(prolink::ClassifyDatagrams(data, lengths, 2, classified), 2u);
+  EXPECT_EQ(classified[0].type, static_cast<uint8_t>(prolink::PacketType::kBeat));
+  EXPECT_EQ(classified[1].type, static_cast<uint8_t>(prolink::PacketType::kCdjStatus));
+
+  const prolink::PacketSpan spans[] = {{data[0], lengths[0], 10}, {data[1], lengths[1], 20}};
+  uint16_t bpm[2] = {};
+  uint32_t beat_number[2] = {};
+  prolink::TempoColumns columns;
+  columns.bpm = bpm;
+  columns.beat = beat_number;
+  ASSERT_EQ(prolink::ParseTempoBatch(spans, 2, columns), 2u);
+  EXPECT_EQ(bpm[0], 12800);
+  EXPECT_EQ(bpm[1], 12000);
+  EXPECT_EQ(beat_number[0], prolink::kNoBeatNumber);
+  EXPECT_EQ(beat_number[1], 9u);
+}
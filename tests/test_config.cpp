@@ -66,3 +66,118 @@ TEST(ConfigValidationTest, AcceptsDefaults) {
   std::string error;
   EXPECT_TRUE(config.Validate(&error));
 }
+
+TEST(ConfigValidationTest, RejectsOutOfRangeRecvBatchSize) {
+  prolink::Config config;
+  config.recv_batch_size = 0;
+  std::string error;
+  EXPECT_FALSE(config.Validate(&error));
+  EXPECT_NE(error.find("recv_batch_size"), std::string::npos);
+
+  config.recv_batch_size = 4096;
+  EXPECT_FALSE(config.Validate(&error));
+}
+
+TEST(ConfigValidationTest, RejectsNegativeSocketBufferSizes) {
+  prolink::Config config;
+  config.recv_buffer_bytes = -1;
+  std::string error;
+  EXPECT_FALSE(config.Validate(&error));
+  EXPECT_NE(error.find("recv_buffer_bytes"), std::string::npos);
+
+  config.recv_buffer_bytes = 1 << 20;
+  config.send_buffer_bytes = -1;
+  EXPECT_FALSE(config.Validate(&error));
+  EXPECT_NE(error.find("send_buffer_bytes"), std::string::npos);
+}
+
+TEST(ConfigValidationTest, RejectsNegativeBusyPollBudget) {
+  prolink::Config config;
+  config.recv_backend = prolink::RecvBackend::kBusyPoll;
+  EXPECT_TRUE(config.Validate(nullptr));
+  config.busy_poll_us = -1;
+  std::string error;
+  EXPECT_FALSE(config.Validate(&error));
+  EXPECT_NE(error.find("busy_poll_us"), std::string::npos);
+}
+
+TEST(ConfigValidationTest, RejectsInvalidBeatLaneSettings) {
+  prolink::Config config;
+  config.beat_lane = true;
+  config.beat_lane_priority = 100;
+  std::string error;
+  EXPECT_FALSE(config.Validate(&error));
+  EXPECT_NE(error.find("beat_lane_priority"), std::string::npos);
+
+  config.beat_lane_priority = 10;
+  EXPECT_TRUE(config.Validate(&error));
+  config.recv_backend = prolink::RecvBackend::kIoUring;
+  EXPECT_FALSE(config.Validate(&error));
+}
+
+TEST(ConfigValidationTest, RejectsInvalidRateLimits) {
+  prolink::Config config;
+  config.rate_limits[prolink::PacketType::kBeat] = {100.0, 10.0};
+  std::string error;
+  EXPECT_FALSE(config.Validate(&error));
+  EXPECT_NE(error.find("beats"), std::string::npos);
+
+  config.rate_limits.erase(prolink::PacketType::kBeat);
+  config.rate_limits[prolink::PacketType::kCdjStatus] = {0.0, 10.0};
+  EXPECT_FALSE(config.Validate(&error));
+  config.rate_limits[prolink::PacketType::kCdjStatus] = {10.0, 0.5};
+  EXPECT_FALSE(config.Validate(&error));
+}
+
+TEST(ConfigValidationTest, RejectsInvalidInterfaces) {
+  prolink::Config config;
+  config.interfaces.resize(2);
+  config.interfaces[0].name = "eth0";
+  config.interfaces[1].name = "eth0";
+  std::string error;
+  EXPECT_FALSE(config.Validate(&error));
+  EXPECT_NE(error.find("interfaces"), std::string::npos);
+
+  config.interfaces[1].name.clear();
+  config.interfaces[1].broadcast_address = "192.168.1";
+  EXPECT_FALSE(config.Validate(&error));
+  config.interfaces[1].broadcast_address = "192.168.1.255";
+#ifdef __linux__
+  EXPECT_TRUE(config.Validate(&error)) << error;
+#endif
+  config.interfaces.resize(9);
+  EXPECT_FALSE(config.Validate(&error));
+}
+
+TEST(ConfigValidationTest, RejectsMalformedNetworkSubnet) {
+  prolink::Config config;
+  config.auto_network = true;
+  config.network_interface = "192.168.1.0/33";
+  std::string error;
+  EXPECT_FALSE(config.Validate(&error));
+  EXPECT_NE(error.find("network_interface"), std::string::npos);
+  config.network_interface = "192.168.1.0/24";
+  EXPECT_TRUE(config.Validate(&error));
+  config.network_interface = "eth0";
+  EXPECT_TRUE(config.Validate(&error));
+}
+
+TEST(ConfigValidationTest, RejectsMonitorInterfaceWithReplay) {
+  prolink::Config config;
+  config.monitor_interface = "lo";
+  config.replay_file = "replay.bin";
+  std::string error;
+  EXPECT_FALSE(config.Validate(&error));
+  EXPECT_NE(error.find("monitor_interface"), std::string::npos);
+}
+
+TEST(ConfigValidationTest, RejectsFollowMasterWithoutParsing) {
+  prolink::Config config;
+  config.follow_master = true;
+  config.parse_packets = false;
+  std::string error;
+  EXPECT_FALSE(config.Validate(&error));
+  EXPECT_NE(error.find("parse_packets"), std::string::npos);
+  config.follow_master = false;
+  EXPECT_TRUE(config.Validate(&error));
+}
@@ -19,12 +19,21 @@ TEST(DeviceTrackingTest, SeenAndUpdatedEvents) {
   EXPECT_EQ(events[0].type, prolink::DeviceEventType::kSeen);
   EXPECT_EQ(events[0].device.device_number, 1);
   EXPECT_EQ(events[0].device.device_name, "CDJ-1");
+  EXPECT_EQ(events[0].device.ip_address, "192.168.0.2");
 
   prolink::test::InjectKeepAlive(session, 1, 0x01, "CDJ-1B", "192.168.0.2", mac);
 
   ASSERT_EQ(events.size(), 2u);
   EXPECT_EQ(events[1].type, prolink::DeviceEventType::kUpdated);
   EXPECT_EQ(events[1].device.device_name, "CDJ-1B");
+
+  prolink::test::InjectKeepAlive(session, 1, 0x01, "CDJ-1B", "192.168.0.3", mac);
+
+  ASSERT_EQ(events.size(), 3u);
+  EXPECT_EQ(events[2].type, prolink::DeviceEventType::kUpdated);
+  const auto devices = session.GetDevices();
+  ASSERT_EQ(devices.size(), 1u);
+  EXPECT_EQ(devices[0].ip_address, "192.168.0.3");
 }
 
 TEST(DeviceTrackingTest, ExpiredDevicesPruned) {
@@ -3,6 +3,8 @@
 
 #include <gtest/gtest.h>
 
+#include <cstring>
+
 TEST(PacketParsingTest, ParseBeatPacket) {
   const uint8_t device = 0x01;
   const std::string name = "CDJ-1";
@@ -90,3 +92,306 @@ TEST(PacketParsingTest, RejectInvalidHeader) {
   prolink::BeatInfo info;
   EXPECT_FALSE(prolink::test::ParseBeatPacket(packet, &info));
 }
+
+TEST(PacketParsingTest, ParsePrecisePositionPacket) {
+  const auto packet =
+      prolink::test::BuildPositionPacket(0x03, "CDJ-3000", 312, 65432, -325, 1284);
+  ASSERT_EQ(packet.size(), 0x3cu);
+
+  prolink::PositionInfo info;
+  ASSERT_TRUE(prolink::test::ParsePositionPacket(packet, &info));
+  EXPECT_EQ(info.device_number, 0x03);
+  EXPECT_EQ(info.track_length_s, 312u);
+  EXPECT_EQ(info.playhead_ms, 65432u);
+  EXPECT_EQ(info.pitch, -325);
+  EXPECT_NEAR(info.pitch_percent(), -3.25, 1e-9);
+  EXPECT_EQ(info.bpm, 12840u);
+  EXPECT_NEAR(info.effective_bpm(), 128.4, 1e-9);
+
+  const std::vector<uint8_t> truncated(packet.begin(), packet.end() - 1);
+  EXPECT_FALSE(prolink::test::ParsePositionPacket(truncated, &info));
+}
+
+TEST(PacketParsingTest, ParseMixerStatusPacket) {
+  const auto packet = prolink::test::BuildMixerStatusPacket(0x21, "DJM-900nexus", 12400, 3, true);
+  ASSERT_EQ(packet.size(), 0x38u);
+
+  prolink::MixerStatusInfo info;
+  ASSERT_TRUE(prolink::test::ParseMixerStatusPacket(packet, &info));
+  EXPECT_EQ(info.device_number, 0x21);
+  EXPECT_EQ(info.device_name, "DJM-900nexus");
+  EXPECT_EQ(info.bpm, 12400u);
+  EXPECT_EQ(info.pitch, prolink::kNeutralPitch);
+  EXPECT_EQ(info.beat_within_bar, 3);
+  EXPECT_EQ(info.master_handoff_to, 0xff);
+  EXPECT_TRUE(info.is_master);
+
+  const auto status = prolink::test::BuildStatusPacket(
+      0x02, "CDJ-2", 12000, prolink::kNeutralPitch, 8, 4, false, false, true, 0xff);
+  EXPECT_FALSE(prolink::test::ParseMixerStatusPacket(status, &info));
+}
+
+TEST(PacketViewTest, BeatViewDecodesInPlace) {
+  const auto packet = prolink::test::BuildBeatPacket(
+      0x02, "CDJ-2", 12800, prolink::kNeutralPitch, 9, 500, 1500);
+
+  const prolink::BeatView view(packet.data(), packet.size());
+  ASSERT_TRUE(view.valid());
+  EXPECT_EQ(view.device_number(), 0x02);
+  EXPECT_EQ(view.device_name(), "CDJ-2");
+  EXPECT_EQ(view.device_name().data(),
+            reinterpret_cast<const char*>(packet.data()) + 0x0b);
+  EXPECT_EQ(view.bpm(), 12800u);
+  EXPECT_EQ(view.beat_within_bar(), 1);
+  EXPECT_EQ(view.next_bar_ms(), 1500u);
+  EXPECT_NEAR(view.effective_bpm(), 128.0, 0.001);
+
+  const prolink::BeatInfo info = prolink::Materialize(view);
+  EXPECT_EQ(info.device_name, "CDJ-2");
+  EXPECT_EQ(info.next_beat_ms, 500u);
+
+  EXPECT_FALSE(prolink::BeatView(packet.data(), packet.size() - 1).valid());
+  EXPECT_FALSE(prolink::StatusView(packet.data(), packet.size()).valid());
+}
+
+TEST(PacketViewTest, StatusViewMatchesParsedStatus) {
+  const auto packet = prolink::test::BuildStatusPacket(
+      0x03, "CDJ-3", 0xffff, prolink::kNeutralPitch, 64, 4, true, false, true, 0x01);
+
+  const prolink::StatusView view(packet.data(), packet.size());
+  ASSERT_TRUE(view.valid());
+  prolink::StatusInfo parsed;
+  ASSERT_TRUE(prolink::test::ParseStatusPacket(packet, &parsed));
+  EXPECT_EQ(view.device_name(), parsed.device_name);
+  EXPECT_FALSE(view.bpm().has_value());
+  EXPECT_FALSE(view.effective_bpm().has_value());
+  EXPECT_EQ(view.beat(), parsed.beat);
+  EXPECT_EQ(view.beat_within_bar(), parsed.beat_within_bar);
+  EXPECT_EQ(view.is_master(), parsed.is_master);
+  EXPECT_EQ(view.is_synced(), parsed.is_synced);
+  EXPECT_EQ(view.is_playing(), parsed.is_playing);
+  EXPECT_EQ(view.master_handoff_to(), parsed.master_handoff_to);
+}
+
+TEST(PacketViewTest, StatusViewDecodesFullFieldSetOnDemand) {
+  auto packet = prolink::test::BuildStatusPacket(
+      0x02, "CDJ-2", 12800, prolink::kNeutralPitch, 16, 1, false, true, true, 0xff);
+  packet[0x28] = 0x03;
+  packet[0x29] = static_cast<uint8_t>(prolink::TrackSourceSlot::kUsb);
+  packet[0x2a] = static_cast<uint8_t>(prolink::TrackType::kRekordbox);
+  packet[0x2c] = 0x00;
+  packet[0x2d] = 0x01;
+  packet[0x2e] = 0x02;
+  packet[0x2f] = 0x03;
+  packet[0x33] = 0x07;
+  packet[0x7b] = static_cast<uint8_t>(prolink::PlayState::kLooping);
+  std::memcpy(packet.data() + 0x7c, "1.85", 4);
+  const uint8_t sync_counter[4] = {0x00, 0x00, 0x00, 0x05};
+  std::memcpy(packet.data() + 0x84, sync_counter, 4);
+  packet[0x89] |= 0x08 | 0x02;
+  packet[0xa4] = 0x00;
+  packet[0xa5] = 0x20;
+  const uint8_t packet_counter[4] = {0x00, 0x00, 0x00, 0x2a};
+  std::memcpy(packet.data() + 0xc8, packet_counter, 4);
+
+  const prolink::StatusView view(packet.data(), packet.size());
+  ASSERT_TRUE(view.valid());
+  EXPECT_EQ(view.track_source_player(), 0x03);
+  EXPECT_EQ(view.track_source_slot(), prolink::TrackSourceSlot::kUsb);
+  EXPECT_EQ(view.track_type(), prolink::TrackType::kRekordbox);
+  EXPECT_EQ(view.rekordbox_id(), 0x00010203u);
+  EXPECT_EQ(view.track_number(), 7);
+  EXPECT_EQ(view.play_state(), prolink::PlayState::kLooping);
+  EXPECT_TRUE(view.is_on_air());
+  EXPECT_TRUE(view.is_bpm_synced());
+  EXPECT_EQ(view.firmware_version(), "1.85");
+  EXPECT_EQ(view.sync_counter(), 5u);
+  EXPECT_EQ(view.beats_until_cue(), 0x20);
+  EXPECT_EQ(view.packet_counter(), 0x2au);
+  EXPECT_FALSE(prolink::StatusView(packet.data(), 0xc8).packet_counter().has_value());
+
+  const prolink::StatusInfo full = prolink::Materialize(view);
+  EXPECT_EQ(full.fields, prolink::kStatusFieldsAll);
+  EXPECT_EQ(full.rekordbox_id, 0x00010203u);
+  EXPECT_EQ(full.play_state, prolink::PlayState::kLooping);
+  EXPECT_EQ(full.firmware_version, "1.85");
+  EXPECT_EQ(full.packet_counter, 0x2au);
+
+  const prolink::StatusInfo tempo_only = prolink::Materialize(view, prolink::kStatusFieldsCore);
+  EXPECT_EQ(tempo_only.fields, prolink::kStatusFieldsCore);
+  EXPECT_EQ(tempo_only.bpm, 12800u);
+  EXPECT_TRUE(tempo_only.is_synced);
+  EXPECT_EQ(tempo_only.rekordbox_id, 0u);
+  EXPECT_FALSE(tempo_only.is_on_air);
+  EXPECT_TRUE(tempo_only.firmware_version.empty());
+
+  const prolink::StatusInfo track = prolink::Materialize(view, prolink::kStatusFieldTrack);
+  EXPECT_EQ(track.track_number, 7);
+  EXPECT_EQ(track.play_state, prolink::PlayState::kNoTrack);
+}
+
+TEST(PacketViewTest, KeepAliveViewDecodesAddresses) {
+  const std::array<uint8_t, 6> mac = {0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff};
+  const auto packet = prolink::test::BuildKeepAlivePacket(
+      0x04, 0x01, "CDJ-4", mac, "192.168.0.10");
+
+  const prolink::KeepAliveView view(packet.data(), packet.size());
+  ASSERT_TRUE(view.valid());
+  EXPECT_EQ(view.device_number(), 0x04);
+  EXPECT_EQ(view.device_name(), "CDJ-4");
+  EXPECT_EQ(view.mac_address(), mac);
+  const uint8_t* ip = packet.data() + 0x2c;
+  uint32_t expected_ip = 0;
+  std::memcpy(&expected_ip, ip, sizeof(expected_ip));
+  EXPECT_EQ(view.ip_address(), expected_ip);
+  EXPECT_EQ(prolink::Materialize(view).ip_address, "192.168.0.10");
+}
+
+TEST(PacketClassifierTest, EveryImplementationAgrees) {
+  const auto beat = prolink::test::BuildBeatPacket(1, "CDJ-1", 12000, prolink::kNeutralPitch,
+                                                   1, 500, 2000);
+  const auto status = prolink::test::BuildStatusPacket(
+      2, "CDJ-2", 12000, prolink::kNeutralPitch, 5, 1, false, true, true, 0xff);
+  const auto keep_alive = prolink::test::BuildKeepAlivePacket(
+      3, 1, "CDJ-3", {0x02, 0, 0, 0, 0, 3}, "192.0.2.3");
+  const auto sync = prolink::test::BuildSyncControlPacket(4, "CDJ-4",
+                                                          prolink::SyncCommand::kEnableSync);
+  auto short_beat = beat;
+  short_beat.resize(0x40);
+  auto bad_magic = beat;
+  bad_magic[3] ^= 0xff;
+  // Valid magic and an undecoded type, shorter than one vector load.
+  std::vector<uint8_t> unknown(beat.begin(), beat.begin() + 12);
+  unknown[0x0a] = 0x55;
+  const std::vector<uint8_t> tiny = {0x51, 0x73};
+
+  // Odd count so the two-at-a-time path also handles a tail datagram.
+  const std::vector<std::vector<uint8_t>> batch = {
+      beat, bad_magic, status, short_beat, tiny, keep_alive, unknown, sync, beat};
+  const std::vector<std::pair<uint32_t, uint8_t>> expected = {
+      {0, 0x28}, {2, 0x0a}, {5, 0x06}, {6, 0x55}, {7, 0x2a}, {8, 0x28}};
+
+  std::vector<prolink::ClassifiedDatagram> public_out(batch.size());
+  std::vector<const uint8_t*> data;
+  std::vector<size_t> lengths;
+  for (const auto& datagram : batch) {
+    data.push_back(datagram.data());
+    lengths.push_back(datagram.size());
+  }
+  ASSERT_EQ(prolink::ClassifyDatagrams(data.data(), lengths.data(), batch.size(),
+                                       public_out.data()),
+            expected.size());
+
+  for (const auto isa : {prolink::ClassifierIsa::kScalar, prolink::ClassifierIsa::kSse2,
+                         prolink::ClassifierIsa::kAvx2}) {
+    std::vector<prolink::ClassifiedDatagram> out;
+    if (!prolink::test::ClassifyWith(isa, batch, &out)) {
+      EXPECT_NE(isa, prolink::ClassifierIsa::kScalar);
+      continue;
+    }
+    ASSERT_EQ(out.size(), expected.size()) << static_cast<int>(isa);
+    for (size_t i = 0; i < expected.size(); ++i) {
+      EXPECT_EQ(out[i].index, expected[i].first) << static_cast<int>(isa);
+      EXPECT_EQ(out[i].type, expected[i].second) << static_cast<int>(isa);
+      EXPECT_EQ(public_out[i].index, expected[i].first);
+      EXPECT_EQ(public_out[i].type, expected[i].second);
+    }
+  }
+}
+
+TEST(PacketClassifierTest, DropsTypesDecodedOnOtherPorts) {
+  using prolink::FaderStartCommand;
+  const auto fader_start = prolink::test::BuildFaderStartPacket(
+      0x21, {FaderStartCommand::kStart, FaderStartCommand::kNoChange,
+             FaderStartCommand::kNoChange, FaderStartCommand::kNoChange});
+  // Stage 2 device number claim: same type byte as fader start, sent to 50000.
+  auto claim = fader_start;
+  claim.resize(0x32);
+  claim[0x24] = 192;
+  const auto keep_alive = prolink::test::BuildKeepAlivePacket(
+      3, 1, "CDJ-3", {0x02, 0, 0, 0, 0, 3}, "192.0.2.3");
+  const std::vector<std::vector<uint8_t>> batch = {claim, fader_start, keep_alive};
+
+  for (const auto isa : {prolink::ClassifierIsa::kScalar, prolink::ClassifierIsa::kSse2,
+                         prolink::ClassifierIsa::kAvx2}) {
+    std::vector<prolink::ClassifiedDatagram> out;
+    if (!prolink::test::ClassifyWith(isa, batch, &out, prolink::kAnnouncePort)) {
+      continue;
+    }
+    ASSERT_EQ(out.size(), 1u) << static_cast<int>(isa);
+    EXPECT_EQ(out[0].index, 2u);
+    ASSERT_TRUE(prolink::test::ClassifyWith(isa, batch, &out, prolink::kBeatPort));
+    ASSERT_EQ(out.size(), 2u) << static_cast<int>(isa);
+    EXPECT_EQ(out[0].index, 0u);
+    EXPECT_EQ(out[1].index, 1u);
+    ASSERT_TRUE(prolink::test::ClassifyWith(isa, batch, &out));
+    EXPECT_EQ(out.size(), 3u) << static_cast<int>(isa);
+  }
+
+  prolink::FaderStartInfo info;
+  EXPECT_TRUE(prolink::DecodeFaderStart(fader_start.data(), fader_start.size(), &info));
+  EXPECT_FALSE(prolink::DecodeFaderStart(claim.data(), claim.size(), &info));
+}
+
+TEST(BulkParseTest, FillsColumnsAndFailureBitmap) {
+  const auto beat = prolink::test::BuildBeatPacket(3, "CDJ-3", 12850, 0x110000, 2, 450, 1800);
+  const auto status = prolink::test::BuildStatusPacket(
+      2, "CDJ-2", 12000, prolink::kNeutralPitch, 77, 4, true, false, true, 0xff);
+  auto short_status = status;
+  short_status.resize(0x80);
+  const std::vector<uint8_t> noise(0x60, 0xab);
+
+  // 70 rows so the failure bitmap spans two words.
+  std::vector<prolink::PacketSpan> spans;
+  for (size_t i = 0; i < 70; ++i) {
+    const std::vector<uint8_t>& packet =
+        i % 4 == 0 ? beat : i % 4 == 1 ? status : i % 4 == 2 ? short_status : noise;
+    spans.push_back({packet.data(), packet.size(), 1000 + i});
+  }
+
+  std::vector<uint8_t> type(spans.size()), device(spans.size()), within(spans.size()),
+      flags(spans.size());
+  std::vector<uint16_t> bpm(spans.size());
+  std::vector<uint32_t> pitch(spans.size()), beat_number(spans.size());
+  std::vector<uint64_t> timestamps(spans.size());
+  std::vector<uint64_t> failures(2, ~uint64_t{0});
+  prolink::TempoColumns columns;
+  columns.type = type.data();
+  columns.device_number = device.data();
+  columns.bpm = bpm.data();
+  columns.pitch = pitch.data();
+  columns.beat = beat_number.data();
+  columns.beat_within_bar = within.data();
+  columns.flags = flags.data();
+  columns.timestamp_us = timestamps.data();
+  columns.failures = failures.data();
+
+  EXPECT_EQ(prolink::ParseTempoBatch(spans.data(), spans.size(), columns), 36u);
+
+  EXPECT_EQ(type[0], 0x28);
+  EXPECT_EQ(device[0], 3);
+  EXPECT_EQ(bpm[0], 12850);
+  EXPECT_EQ(pitch[0], 0x110000u);
+  EXPECT_EQ(beat_number[0], prolink::kNoBeatNumber);
+  EXPECT_EQ(within[0], 2);
+  EXPECT_EQ(flags[0], 0);
+  EXPECT_EQ(timestamps[0], 1000u);
+
+  EXPECT_EQ(type[65], 0x0a);
+  EXPECT_EQ(device[65], 2);
+  EXPECT_EQ(bpm[65], 12000);
+  EXPECT_EQ(pitch[65], prolink::kNeutralPitch);
+  EXPECT_EQ(beat_number[65], 77u);
+  EXPECT_EQ(within[65], 4);
+  EXPECT_EQ(flags[65], 0x60);
+  EXPECT_EQ(timestamps[65], 1065u);
+
+  EXPECT_EQ(type[2], 0);
+  EXPECT_EQ(timestamps[3], 0u);
+  for (size_t i = 0; i < spans.size(); ++i) {
+    const bool failed = ((failures[i / 64] >> (i % 64)) & 1) != 0;
+    EXPECT_EQ(failed, i % 4 >= 2) << i;
+  }
+  // Bits past the last row are cleared.
+  EXPECT_EQ(failures[1] >> 6, 0u);
+}
@@ -1,4 +1,4 @@
-// Packet layout tests for sync and master handoff packets.
+// Packet layout tests for the packet builders.
 #include "prolink/test_hooks.h"
 
 #include <gtest/gtest.h>
@@ -83,3 +83,53 @@ TEST(PacketLayoutTest, MasterHandoffResponseOffsets) {
   EXPECT_EQ(packet[0x27], device);
   EXPECT_EQ(packet[0x2b], 0x01);
 }
+
+TEST(PacketLayoutTest, BeatPacketOffsets) {
+  const uint8_t device = 0x04;
+  const std::string name = "beat-device";
+  const auto packet = prolink::test::BuildBeatPacket(device, name, 12850, 0x100000, 3,
+                                                     0x01020304, 0x0a0b0c0d);
+
+  EXPECT_EQ(packet.size(), 0x60);
+  ExpectHeader(packet);
+  ExpectDeviceName(packet, name);
+  EXPECT_EQ(packet[0x0a], 0x28);
+  EXPECT_EQ(packet[0x21], device);
+  EXPECT_EQ(packet[0x24], 0x01);
+  EXPECT_EQ(packet[0x27], 0x04);
+  EXPECT_EQ(packet[0x2c], 0x0a);
+  EXPECT_EQ(packet[0x2f], 0x0d);
+  EXPECT_EQ(packet[0x55], 0x10);
+  EXPECT_EQ(packet[0x56], 0x00);
+  EXPECT_EQ(packet[0x57], 0x00);
+  EXPECT_EQ(packet[0x5a], 0x32);
+  EXPECT_EQ(packet[0x5b], 0x32);
+  EXPECT_EQ(packet[0x5c], 3);
+  EXPECT_EQ(packet[0x5f], device);
+}
+
+TEST(PacketLayoutTest, KeepAlivePacketOffsets) {
+  const std::array<uint8_t, 6> mac = {0x02, 0x11, 0x22, 0x33, 0x44, 0x55};
+  const auto packet =
+      prolink::test::BuildKeepAlivePacket(0x05, 0x01, "cdj", mac, "192.0.2.9");
+
+  EXPECT_EQ(packet.size(), 0x36);
+  ExpectHeader(packet);
+  EXPECT_EQ(packet[0x0a], 0x06);
+  EXPECT_EQ(packet[0x0b], 0x00);
+  EXPECT_EQ(packet[0x0c], 'c');
+  EXPECT_EQ(packet[0x0e], 'j');
+  EXPECT_EQ(packet[0x0f], 0x00);
+  EXPECT_EQ(packet[0x23], 0x36);
+  EXPECT_EQ(packet[0x24], 0x05);
+  EXPECT_EQ(packet[0x25], 0x01);
+  for (size_t i = 0; i < mac.size(); ++i) {
+    EXPECT_EQ(packet[0x26 + i], mac[i]);
+  }
+  EXPECT_EQ(packet[0x2c], 192);
+  EXPECT_EQ(packet[0x2d], 0);
+  EXPECT_EQ(packet[0x2e], 2);
+  EXPECT_EQ(packet[0x2f], 9);
+  EXPECT_EQ(packet[0x30], 0x01);
+  EXPECT_EQ(packet[0x34], 0x01);
+}
@@ -0,0 +1,1054 @@
+// Loopback tests for the socket receive path.
+#include "prolink/test_hooks.h"
+
+#include <gtest/gtest.h>
+
+#include <arpa/inet.h>
+#include <dirent.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+class LoopbackSender {
+ public:
+  // A nonzero source binds the socket to that loopback address.
+  explicit LoopbackSender(uint32_t source = INADDR_ANY) : fd_(::socket(AF_INET, SOCK_DGRAM, 0)) {
+    if (fd_ >= 0 && source != INADDR_ANY) {
+      sockaddr_in addr{};
+      addr.sin_family = AF_INET;
+      addr.sin_addr.s_addr = htonl(source);
+      ::bind(fd_, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr));
+    }
+  }
+  ~LoopbackSender() {
+    if (fd_ >= 0) {
+      ::close(fd_);
+    }
+  }
+
+  bool Send(const std::vector<uint8_t>& packet, uint16_t port,
+            uint32_t address = INADDR_LOOPBACK) {
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(address);
+    return ::sendto(fd_, packet.data(), packet.size(), 0,
+                    reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) ==
+           static_cast<ssize_t>(packet.size());
+  }
+
+ private:
+  int fd_ = -1;
+};
+
+prolink::Config ListenerConfig() {
+  prolink::Config config;
+  config.bind_address = "127.0.0.1";
+  config.send_beats = false;
+  config.send_status = false;
+  config.send_announces = false;
+  // Keep Stop() fast: the status and prune threads sleep between iterations.
+  config.status_interval_ms = 10;
+  config.device_prune_interval = std::chrono::milliseconds(10);
+  return config;
+}
+
+// Open descriptors of this process.
+size_t OpenFdCount() {
+  DIR* dir = ::opendir("/proc/self/fd");
+  if (!dir) {
+    return 0;
+  }
+  size_t count = 0;
+  while (::readdir(dir)) {
+    ++count;
+  }
+  ::closedir(dir);
+  return count;
+}
+
+template <typename Predicate>
+bool WaitFor(Predicate predicate,
+             std::chrono::milliseconds timeout = std::chrono::milliseconds(2000)) {
+  const auto deadline = std::chrono::steady_clock::now() + timeout;
+  while (std::chrono::steady_clock::now() < deadline) {
+    if (predicate()) {
+      return true;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  return predicate();
+}
+
+}  // namespace
+
+TEST(ReceiveTest, BatchedReceiveDeliversEveryBeat) {
+  prolink::Config config = ListenerConfig();
+  config.recv_batch_size = 4;
+  prolink::Session session(config);
+
+  std::atomic<int> beats{0};
+  session.SetBeatCallback([&](const prolink::BeatInfo&) { beats.fetch_add(1); });
+  ASSERT_TRUE(session.Start()) << session.GetLastError();
+
+  LoopbackSender sender;
+  const auto packet = prolink::test::BuildBeatPacket(
+      0x02, "CDJ-2", 12800, prolink::kNeutralPitch, 1, 500, 2000);
+  constexpr int kBurst = 50;
+  for (int i = 0; i < kBurst; ++i) {
+    ASSERT_TRUE(sender.Send(packet, prolink::kBeatPort));
+  }
+
+  EXPECT_TRUE(WaitFor([&]() { return beats.load() == kBurst; }));
+  session.Stop();
+
+  const auto metrics = session.GetMetrics();
+  EXPECT_EQ(metrics.datagrams_received, static_cast<uint64_t>(kBurst));
+  EXPECT_GE(metrics.receive_wakeups, 1u);
+  EXPECT_GE(metrics.average_packets_per_wakeup(), 1.0);
+}
+
+TEST(ReceiveTest, SelectBackendDeliversPackets) {
+  prolink::Config config = ListenerConfig();
+  config.recv_backend = prolink::RecvBackend::kSelect;
+  prolink::Session session(config);
+
+  std::atomic<int> statuses{0};
+  session.SetStatusCallback([&](const prolink::StatusInfo&) { statuses.fetch_add(1); });
+  ASSERT_TRUE(session.Start()) << session.GetLastError();
+
+  LoopbackSender sender;
+  const auto packet = prolink::test::BuildStatusPacket(
+      0x03, "CDJ-3", 12000, prolink::kNeutralPitch, 16, 4,
+      false, false, true, 0xff);
+  ASSERT_TRUE(sender.Send(packet, prolink::kStatusPort));
+
+  EXPECT_TRUE(WaitFor([&]() { return statuses.load() == 1; }));
+  session.Stop();
+}
+
+#ifdef __linux__
+TEST(ReceiveTest, BusyPollBackendDeliversPackets) {
+  prolink::Config config = ListenerConfig();
+  config.recv_backend = prolink::RecvBackend::kBusyPoll;
+  config.busy_poll_backoff = prolink::BusyPollBackoff::kYield;
+  prolink::Session session(config);
+
+  std::atomic<int> beats{0};
+  session.SetBeatCallback([&](const prolink::BeatInfo&) { beats.fetch_add(1); });
+  ASSERT_TRUE(session.Start()) << session.GetLastError();
+
+  LoopbackSender sender;
+  const auto packet = prolink::test::BuildBeatPacket(
+      0x02, "CDJ-2", 12800, prolink::kNeutralPitch, 1, 500, 2000);
+  for (int i = 0; i < 10; ++i) {
+    ASSERT_TRUE(sender.Send(packet, prolink::kBeatPort));
+  }
+  EXPECT_TRUE(WaitFor([&]() { return beats.load() == 10; }));
+
+  // The spinning thread picks up a raw callback set while it runs.
+  std::atomic<int> raw_packets{0};
+  session.SetRawPacketCallback([&](const prolink::RawPacket&) { raw_packets.fetch_add(1); });
+  EXPECT_TRUE(WaitFor([&]() {
+    return sender.Send(packet, prolink::kBeatPort) && raw_packets.load() > 0;
+  }));
+
+  const auto start = std::chrono::steady_clock::now();
+  session.Stop();
+  EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(500));
+  EXPECT_GT(session.GetMetrics().receive_wakeups, 0u);
+}
+
+TEST(ReceiveTest, BeatLaneIsNotDelayedBySlowStatusHandling) {
+  prolink::Config config = ListenerConfig();
+  config.beat_lane = true;
+  prolink::Session session(config);
+
+  std::atomic<int> beats{0};
+  std::atomic<int> statuses{0};
+  session.SetBeatCallback([&](const prolink::BeatInfo&) { beats.fetch_add(1); });
+  session.SetStatusCallback([&](const prolink::StatusInfo&) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    statuses.fetch_add(1);
+  });
+  ASSERT_TRUE(session.Start()) << session.GetLastError();
+
+  LoopbackSender sender;
+  const auto status = prolink::test::BuildStatusPacket(
+      0x03, "CDJ-3", 12000, prolink::kNeutralPitch, 8, 4, false, false, true, 0xff);
+  const auto beat = prolink::test::BuildBeatPacket(
+      0x02, "CDJ-2", 12800, prolink::kNeutralPitch, 1, 500, 2000);
+  // Saturate the status lane, then send beats while it is still busy.
+  for (int i = 0; i < 10; ++i) {
+    ASSERT_TRUE(sender.Send(status, prolink::kStatusPort));
+  }
+  for (int i = 0; i < 10; ++i) {
+    ASSERT_TRUE(sender.Send(beat, prolink::kBeatPort));
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  }
+  ASSERT_TRUE(WaitFor([&]() { return beats.load() == 10; }));
+  EXPECT_LT(statuses.load(), 10);
+  ASSERT_TRUE(WaitFor([&]() { return statuses.load() == 10; }));
+
+  const auto metrics = session.GetMetrics();
+  session.Stop();
+  EXPECT_EQ(metrics.beat_latency.count, 10u);
+  EXPECT_EQ(metrics.status_latency.count, 10u);
+  EXPECT_LT(metrics.beat_latency.max_ns, 20'000'000u);
+  EXPECT_GT(metrics.status_latency.max_ns, 100'000'000u);
+  EXPECT_LT(metrics.beat_latency.average_us(), metrics.status_latency.average_us());
+}
+
+TEST(ReceiveTest, EpollStopWakesReceiveThreadImmediately) {
+  prolink::Config config = ListenerConfig();
+  config.recv_backend = prolink::RecvBackend::kEpoll;
+  prolink::Session session(config);
+  ASSERT_TRUE(session.Start()) << session.GetLastError();
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+  const auto start = std::chrono::steady_clock::now();
+  session.Stop();
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+  EXPECT_LT(elapsed, std::chrono::milliseconds(150));
+}
+#endif
+
+TEST(ReceiveTest, BeatCarriesKernelReceiveTime) {
+  prolink::Config config = ListenerConfig();
+  prolink::Session session(config);
+
+  std::atomic<bool> received{false};
+  std::chrono::steady_clock::time_point receive_time;
+  std::chrono::steady_clock::time_point callback_time;
+  session.SetBeatCallback([&](const prolink::BeatInfo& beat) {
+    receive_time = beat.receive_time;
+    callback_time = std::chrono::steady_clock::now();
+    received = true;
+  });
+  ASSERT_TRUE(session.Start()) << session.GetLastError();
+
+  LoopbackSender sender;
+  const auto sent_at = std::chrono::steady_clock::now();
+  ASSERT_TRUE(sender.Send(prolink::test::BuildBeatPacket(
+                              0x01, "CDJ-1", 12800, prolink::kNeutralPitch, 2, 500, 1500),
+                          prolink::kBeatPort));
+  ASSERT_TRUE(WaitFor([&]() { return received.load(); }));
+  session.Stop();
+
+  // Allow for clock mapping error between the realtime and steady domains.
+  EXPECT_GE(receive_time, sent_at - std::chrono::milliseconds(5));
+  EXPECT_LE(receive_time, callback_time);
+}
+
+// Replay a capture file and count the beats it delivers.
+int ReplayBeats(const std::string& path, std::string* error = nullptr) {
+  prolink::Config config = ListenerConfig();
+  config.replay_file = path;
+  prolink::Session session(config);
+  std::atomic<int> beats{0};
+  session.SetBeatCallback([&](const prolink::BeatInfo&) { beats.fetch_add(1); });
+  if (!session.Start()) {
+    if (error) {
+      *error = session.GetLastError();
+    }
+    return -1;
+  }
+  WaitFor([&]() { return beats.load() > 0; });
+  session.Stop();
+  return beats.load();
+}
+
+TEST(ReceiveTest, CaptureFilesAreVersionedAndLegacyFilesReplay) {
+  const std::string path = ::testing::TempDir() + "prolink_capture.bin";
+  const auto beat = prolink::test::BuildBeatPacket(
+      0x01, "CDJ-1", 12800, prolink::kNeutralPitch, 2, 500, 1500);
+  {
+    prolink::Config config = ListenerConfig();
+    config.capture_file = path;
+    prolink::Session session(config);
+    std::atomic<bool> received{false};
+    session.SetBeatCallback([&](const prolink::BeatInfo&) { received = true; });
+    ASSERT_TRUE(session.Start()) << session.GetLastError();
+    LoopbackSender sender;
+    ASSERT_TRUE(sender.Send(beat, prolink::kBeatPort));
+    ASSERT_TRUE(WaitFor([&]() { return received.load(); }));
+    session.Stop();
+  }
+  std::vector<char> bytes;
+  {
+    std::ifstream in(path, std::ios::binary);
+    bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+  }
+  // Header, then timestamp, length, port and the datagram.
+  ASSERT_EQ(bytes.size(), 8 + 8 + 4 + 2 + beat.size());
+  EXPECT_EQ(std::string(bytes.data(), 4), "PLCP");
+  uint32_t version = 0;
+  std::memcpy(&version, bytes.data() + 4, sizeof(version));
+  EXPECT_EQ(version, 1u);
+  uint16_t port = 0;
+  std::memcpy(&port, bytes.data() + 20, sizeof(port));
+  EXPECT_EQ(port, prolink::kBeatPort);
+  EXPECT_EQ(ReplayBeats(path), 1);
+
+  // Headerless captures from older releases replay without a port.
+  {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    const uint64_t timestamp_us = 1000;
+    const uint32_t length = static_cast<uint32_t>(beat.size());
+    out.write(reinterpret_cast<const char*>(&timestamp_us), sizeof(timestamp_us));
+    out.write(reinterpret_cast<const char*>(&length), sizeof(length));
+    out.write(reinterpret_cast<const char*>(beat.data()),
+              static_cast<std::streamsize>(beat.size()));
+  }
+  EXPECT_EQ(ReplayBeats(path), 1);
+
+  {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    const uint32_t future_version = 99;
+    out.write("PLCP", 4);
+    out.write(reinterpret_cast<const char*>(&future_version), sizeof(future_version));
+  }
+  std::string error;
+  EXPECT_EQ(ReplayBeats(path, &error), -1);
+  EXPECT_NE(error.find("version 99"), std::string::npos) << error;
+  std::remove(path.c_str());
+}
+
+TEST(ReceiveTest, IoUringBackendReceivesAndSends) {
+  prolink::Config config = ListenerConfig();
+  config.recv_backend = prolink::RecvBackend::kIoUring;
+  config.broadcast_address = "127.0.0.1";
+  if (!config.Validate()) {
+    GTEST_SKIP() << "built without PROLINK_ENABLE_IO_URING";
+  }
+  prolink::Session session(config);
+
+  std::atomic<int> beats{0};
+  session.SetBeatCallback([&](const prolink::BeatInfo&) { beats.fetch_add(1); });
+  ASSERT_TRUE(session.Start()) << session.GetLastError();
+
+  LoopbackSender sender;
+  const auto packet = prolink::test::BuildBeatPacket(
+      0x02, "CDJ-2", 12800, prolink::kNeutralPitch, 1, 500, 2000);
+  constexpr int kBurst = 20;
+  for (int i = 0; i < kBurst; ++i) {
+    ASSERT_TRUE(sender.Send(packet, prolink::kBeatPort));
+  }
+  EXPECT_TRUE(WaitFor([&]() { return beats.load() == kBurst; }));
+
+  // Unknown target falls back to broadcast_address, which loops back to us.
+  session.SendSyncControl(0x05, prolink::SyncCommand::kEnableSync);
+  EXPECT_TRUE(WaitFor([&]() { return session.GetMetrics().packets_sent == 1; }));
+  session.Stop();
+  EXPECT_EQ(session.GetMetrics().send_errors, 0u);
+  EXPECT_EQ(session.GetMetrics().broadcast_fallbacks, 1u);
+}
+
+#ifdef __linux__
+TEST(ReceiveTest, MonitorModeSeesUnicastForOtherHosts) {
+  prolink::Config config = ListenerConfig();
+  config.monitor_interface = "lo";
+  prolink::Session session(config);
+
+  std::atomic<int> statuses{0};
+  std::atomic<int> beats{0};
+  session.SetStatusCallback([&](const prolink::StatusInfo&) { statuses.fetch_add(1); });
+  session.SetBeatCallback([&](const prolink::BeatInfo&) { beats.fetch_add(1); });
+  if (!session.Start()) {
+    GTEST_SKIP() << "AF_PACKET unavailable: " << session.GetLastError();
+  }
+
+  // Nothing is bound to these ports in monitor mode; the frames are only
+  // visible through the packet ring.
+  LoopbackSender sender;
+  ASSERT_TRUE(sender.Send(prolink::test::BuildStatusPacket(
+                              0x02, "CDJ-2", 12000, prolink::kNeutralPitch, 8, 4,
+                              false, false, true, 0xff),
+                          prolink::kStatusPort));
+  ASSERT_TRUE(sender.Send(prolink::test::BuildBeatPacket(
+                              0x02, "CDJ-2", 12000, prolink::kNeutralPitch, 1, 500, 2000),
+                          prolink::kBeatPort));
+  EXPECT_TRUE(WaitFor([&]() { return statuses.load() == 1 && beats.load() == 1; }));
+  session.Stop();
+  EXPECT_EQ(session.GetMetrics().monitor_drops, 0u);
+}
+#endif
+
+TEST(ReceiveTest, KernelFilterDropsForeignDatagrams) {
+  prolink::Config config = ListenerConfig();
+  prolink::Session session(config);
+
+  std::atomic<int> statuses{0};
+  session.SetStatusCallback([&](const prolink::StatusInfo&) { statuses.fetch_add(1); });
+  ASSERT_TRUE(session.Start()) << session.GetLastError();
+
+  LoopbackSender sender;
+  ASSERT_TRUE(sender.Send(std::vector<uint8_t>(64, 0xab), prolink::kStatusPort));
+  auto short_status = prolink::test::BuildStatusPacket(
+      0x02, "CDJ-2", 12000, prolink::kNeutralPitch, 8, 4, false, false, true, 0xff);
+  short_status.resize(0x40);
+  ASSERT_TRUE(sender.Send(short_status, prolink::kStatusPort));
+  ASSERT_TRUE(sender.Send(prolink::test::BuildStatusPacket(
+                              0x02, "CDJ-2", 12000, prolink::kNeutralPitch, 8, 4,
+                              false, false, true, 0xff),
+                          prolink::kStatusPort));
+  ASSERT_TRUE(WaitFor([&]() { return statuses.load() == 1; }));
+
+  const auto metrics = session.GetMetrics();
+  session.Stop();
+#ifdef __linux__
+  EXPECT_EQ(metrics.kernel_drops, 2u);
+  EXPECT_EQ(metrics.userspace_rejected, 0u);
+  EXPECT_EQ(metrics.parse_errors, 0u);
+  EXPECT_EQ(metrics.datagrams_received, 1u);
+#endif
+}
+
+TEST(ReceiveTest, UserspaceRejectsWithoutKernelFilter) {
+  prolink::Config config = ListenerConfig();
+  config.kernel_filter = false;
+  prolink::Session session(config);
+  ASSERT_TRUE(session.Start()) << session.GetLastError();
+
+  LoopbackSender sender;
+  ASSERT_TRUE(sender.Send(std::vector<uint8_t>(64, 0xab), prolink::kStatusPort));
+  EXPECT_TRUE(WaitFor([&]() { return session.GetMetrics().userspace_rejected == 1; }));
+  session.Stop();
+  EXPECT_EQ(session.GetMetrics().kernel_drops, 0u);
+}
+
+TEST(ReceiveTest, ReportsSocketQueueOverflow) {
+  prolink::Config config = ListenerConfig();
+  config.recv_buffer_bytes = 4096;
+  prolink::Session session(config);
+
+  std::atomic<bool> release{false};
+  std::atomic<int> beats{0};
+  session.SetBeatCallback([&](const prolink::BeatInfo&) {
+    // Stall the receive thread on the first beat so the queue overflows.
+    while (!release.load()) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    beats.fetch_add(1);
+  });
+  ASSERT_TRUE(session.Start()) << session.GetLastError();
+
+  const auto running = session.GetMetrics();
+  ASSERT_EQ(running.sockets.size(), 3u);
+  EXPECT_EQ(running.sockets[0].port, prolink::kBeatPort);
+  EXPECT_EQ(running.sockets[1].port, prolink::kStatusPort);
+  EXPECT_EQ(running.sockets[2].port, prolink::kAnnouncePort);
+  for (const auto& socket : running.sockets) {
+    EXPECT_GT(socket.recv_buffer_bytes, 0u);
+    EXPECT_EQ(socket.kernel_drops, 0u);
+  }
+
+  LoopbackSender sender;
+  const auto packet = prolink::test::BuildBeatPacket(
+      0x02, "CDJ-2", 12800, prolink::kNeutralPitch, 1, 500, 2000);
+  ASSERT_TRUE(sender.Send(packet, prolink::kBeatPort));
+  ASSERT_TRUE(WaitFor([&]() { return session.GetMetrics().datagrams_received == 1; }));
+  for (int i = 0; i < 200; ++i) {
+    sender.Send(packet, prolink::kBeatPort);
+  }
+  EXPECT_GT(session.GetMetrics().sockets[0].queued_bytes, 0u);
+  release = true;
+  ASSERT_TRUE(WaitFor([&]() { return session.GetMetrics().sockets[0].queued_bytes == 0; }));
+  // Drops are visible without another datagram arriving on the socket.
+  prolink::SessionMetrics metrics;
+  ASSERT_TRUE(WaitFor([&]() {
+    metrics = session.GetMetrics();
+    return static_cast<uint64_t>(beats.load()) == metrics.datagrams_received;
+  }));
+  EXPECT_GT(metrics.sockets[0].kernel_drops, 0u);
+  EXPECT_EQ(metrics.sockets[0].kernel_drops, 201 - metrics.datagrams_received);
+  EXPECT_EQ(metrics.kernel_drops, metrics.sockets[0].kernel_drops);
+  session.Stop();
+  EXPECT_TRUE(session.GetMetrics().sockets.empty());
+}
+
+TEST(ReceiveTest, OversizedPacketsAreCountedAsTruncated) {
+  prolink::Config config = ListenerConfig();
+  prolink::Session session(config);
+
+  std::atomic<int> statuses{0};
+  session.SetStatusCallback([&](const prolink::StatusInfo&) { statuses.fetch_add(1); });
+  ASSERT_TRUE(session.Start()) << session.GetLastError();
+
+  LoopbackSender sender;
+  auto status = prolink::test::BuildStatusPacket(
+      0x03, "CDJ-3", 12000, prolink::kNeutralPitch, 8, 4, false, false, true, 0xff);
+  // Newer players send longer status packets; they must parse in place.
+  status.resize(0x400);
+  ASSERT_TRUE(sender.Send(status, prolink::kStatusPort));
+  ASSERT_TRUE(WaitFor([&]() { return statuses.load() == 1; }));
+
+  status.resize(0x1000);
+  ASSERT_TRUE(sender.Send(status, prolink::kStatusPort));
+  ASSERT_TRUE(WaitFor([&]() { return session.GetMetrics().truncated_packets == 1; }));
+
+  const auto metrics = session.GetMetrics();
+  session.Stop();
+  EXPECT_EQ(statuses.load(), 1);
+  EXPECT_EQ(metrics.truncated_by_type.size(), 1u);
+  EXPECT_EQ(metrics.truncated_by_type.at(static_cast<uint8_t>(prolink::PacketType::kCdjStatus)),
+            1u);
+  EXPECT_EQ(metrics.parse_errors, 0u);
+  EXPECT_EQ(metrics.userspace_rejected, 0u);
+}
+
+TEST(ReceiveTest, RateLimiterShedsStatusFloodButNotBeats) {
+  prolink::Config config = ListenerConfig();
+  config.recv_buffer_bytes = 1 << 20;
+  config.rate_limits[prolink::PacketType::kCdjStatus] = {1.0, 5.0};
+  prolink::Session session(config);
+
+  std::atomic<int> beats{0};
+  std::atomic<int> statuses{0};
+  session.SetBeatCallback([&](const prolink::BeatInfo&) { beats.fetch_add(1); });
+  session.SetStatusCallback([&](const prolink::StatusInfo&) { statuses.fetch_add(1); });
+  ASSERT_TRUE(session.Start()) << session.GetLastError();
+
+  LoopbackSender sender;
+  const auto status = prolink::test::BuildStatusPacket(
+      0x03, "CDJ-3", 12000, prolink::kNeutralPitch, 8, 4, false, false, true, 0xff);
+  const auto beat = prolink::test::BuildBeatPacket(
+      0x03, "CDJ-3", 12000, prolink::kNeutralPitch, 1, 500, 2000);
+  constexpr int kStorm = 200;
+  for (int i = 0; i < kStorm; ++i) {
+    ASSERT_TRUE(sender.Send(status, prolink::kStatusPort));
+    if (i % 20 == 0) {
+      ASSERT_TRUE(sender.Send(beat, prolink::kBeatPort));
+    }
+  }
+  ASSERT_TRUE(WaitFor([&]() {
+    return beats.load() == kStorm / 20 &&
+           static_cast<int>(session.GetMetrics().rate_limited) + statuses.load() == kStorm;
+  }));
+
+  const auto metrics = session.GetMetrics();
+  session.Stop();
+  EXPECT_GE(statuses.load(), 5);
+  EXPECT_LE(statuses.load(), 7);
+  ASSERT_EQ(metrics.rate_limited_sources.size(), 1u);
+  const auto& source = metrics.rate_limited_sources[0];
+  EXPECT_EQ(source.source_ip, "127.0.0.1");
+  EXPECT_EQ(source.device_number, 0x03);
+  EXPECT_EQ(source.packet_type, prolink::PacketType::kCdjStatus);
+  EXPECT_EQ(source.dropped, metrics.rate_limited);
+  EXPECT_EQ(metrics.parse_errors, 0u);
+}
+
+#ifdef __linux__
+TEST(ReceiveTest, RateLimiterEvictsIdleSourcesWhenFull) {
+  prolink::Config config = ListenerConfig();
+  config.recv_buffer_bytes = 1 << 20;
+  config.rate_limits[prolink::PacketType::kCdjStatus] = {1.0, 1.0};
+  prolink::Session session(config);
+
+  std::atomic<int> statuses{0};
+  session.SetStatusCallback([&](const prolink::StatusInfo&) { statuses.fetch_add(1); });
+  ASSERT_TRUE(session.Start()) << session.GetLastError();
+
+  // 16 loopback sources with 256 device numbers each fill the 4096 buckets.
+  constexpr int kSources = 16;
+  std::vector<std::unique_ptr<LoopbackSender>> senders;
+  for (int i = 0; i < kSources + 1; ++i) {
+    senders.push_back(std::make_unique<LoopbackSender>(INADDR_LOOPBACK + 1 + i));
+  }
+  auto status_from = [](int device) {
+    return prolink::test::BuildStatusPacket(static_cast<uint8_t>(device), "CDJ-3", 12000,
+                                            prolink::kNeutralPitch, 8, 4, false, false, true,
+                                            0xff);
+  };
+  for (int i = 0; i < kSources; ++i) {
+    for (int device = 0; device < 256; ++device) {
+      ASSERT_TRUE(senders[i]->Send(status_from(device), prolink::kStatusPort));
+    }
+    ASSERT_TRUE(WaitFor([&]() { return statuses.load() == 256 * (i + 1); }));
+  }
+  // One tracked source over its limit, and one source the full table cannot track.
+  ASSERT_TRUE(senders[0]->Send(status_from(1), prolink::kStatusPort));
+  ASSERT_TRUE(senders[kSources]->Send(status_from(1), prolink::kStatusPort));
+  ASSERT_TRUE(WaitFor([&]() { return session.GetMetrics().rate_limited == 2; }));
+
+  prolink::test::PruneDevices(session,
+                              std::chrono::steady_clock::now() + std::chrono::minutes(1));
+  ASSERT_TRUE(senders[kSources]->Send(status_from(1), prolink::kStatusPort));
+  ASSERT_TRUE(WaitFor([&]() { return statuses.load() == 256 * kSources + 1; }));
+  const auto metrics = session.GetMetrics();
+  session.Stop();
+  // The new source was admitted; the evicted bucket's drop is still reported.
+  EXPECT_EQ(metrics.rate_limited, 2u);
+  ASSERT_EQ(metrics.rate_limited_sources.size(), 1u);
+  EXPECT_EQ(metrics.rate_limited_sources[0].source_ip, "127.0.0.2");
+  EXPECT_EQ(metrics.rate_limited_sources[0].device_number, 1);
+  EXPECT_EQ(metrics.rate_limited_sources[0].dropped, 1u);
+}
+
+TEST(ReceiveTest, MultiInterfaceTagsIngressAndDropsDuplicates) {
+  // Two interfaces on loopback addresses stand in for two NICs.
+  prolink::Config config = ListenerConfig();
+  config.interfaces.resize(2);
+  config.interfaces[0].name = "lo";
+  config.interfaces[0].bind_address = "127.0.0.1";
+  config.interfaces[0].broadcast_address = "127.0.0.1";
+  config.interfaces[1].name = "lo";
+  config.interfaces[1].bind_address = "127.0.0.2";
+  config.interfaces[1].broadcast_address = "127.0.0.2";
+  prolink::Session session(config);
+
+  std::mutex mutex;
+  std::vector<uint8_t> ingress;
+  session.SetBeatCallback([&](const prolink::BeatInfo& beat) {
+    std::lock_guard<std::mutex> lock(mutex);
+    ingress.push_back(beat.interface_index);
+  });
+  if (!session.Start()) {
+    GTEST_SKIP() << "cannot bind to lo: " << session.GetLastError();
+  }
+
+  LoopbackSender sender;
+  const auto beat = prolink::test::BuildBeatPacket(
+      0x02, "CDJ-2", 12000, prolink::kNeutralPitch, 1, 500, 2000);
+  ASSERT_TRUE(sender.Send(beat, prolink::kBeatPort, INADDR_LOOPBACK));
+  ASSERT_TRUE(sender.Send(beat, prolink::kBeatPort, INADDR_LOOPBACK + 1));
+  ASSERT_TRUE(WaitFor([&]() { return session.GetMetrics().datagrams_received == 2; }));
+  const auto other = prolink::test::BuildBeatPacket(
+      0x03, "CDJ-3", 12000, prolink::kNeutralPitch, 2, 500, 2000);
+  ASSERT_TRUE(sender.Send(other, prolink::kBeatPort, INADDR_LOOPBACK + 1));
+  ASSERT_TRUE(WaitFor([&]() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return ingress.size() == 2;
+  }));
+
+  const auto metrics = session.GetMetrics();
+  const auto devices = session.GetDevices();
+  session.Stop();
+  EXPECT_EQ(metrics.duplicates_dropped, 1u);
+  EXPECT_EQ(metrics.sockets.size(), 6u);
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    EXPECT_EQ(ingress[1], 1);
+  }
+  for (const auto& device : devices) {
+    if (device.device_number == 0x03) {
+      EXPECT_EQ(device.interface_index, 1);
+    }
+  }
+}
+
+TEST(ReceiveTest, ControlPacketsFollowDeviceToAnotherInterface) {
+  for (const bool connect : {false, true}) {
+    prolink::Config config = ListenerConfig();
+    config.connect_control_sockets = connect;
+    config.interfaces.resize(2);
+    config.interfaces[0].name = "lo";
+    config.interfaces[0].bind_address = "127.0.0.1";
+    config.interfaces[0].broadcast_address = "127.0.0.1";
+    config.interfaces[1].name = "lo";
+    config.interfaces[1].bind_address = "127.0.0.2";
+    config.interfaces[1].broadcast_address = "127.0.0.2";
+    prolink::Session session(config);
+
+    // Source addresses of the sync control packets that loop back to us.
+    std::mutex mutex;
+    std::vector<uint32_t> control_sources;
+    session.SetRawPacketCallback([&](const prolink::RawPacket& raw) {
+      if (raw.size > 0x0a && raw.data[0x0a] == 0x2a) {
+        std::lock_guard<std::mutex> lock(mutex);
+        control_sources.push_back(raw.source_ip);
+      }
+    });
+    if (!session.Start()) {
+      GTEST_SKIP() << "cannot bind to lo: " << session.GetLastError();
+    }
+
+    // The device keeps its address but is next heard on the second interface.
+    LoopbackSender sender;
+    std::array<uint8_t, 6> mac = {0x00, 0x01, 0x02, 0x03, 0x04, 0x05};
+    for (uint8_t index = 0; index < 2; ++index) {
+      // A different MAC keeps the duplicate filter from dropping the copy.
+      mac[5] = index;
+      ASSERT_TRUE(sender.Send(
+          prolink::test::BuildKeepAlivePacket(0x05, 0x01, "CDJ-5", mac, "127.0.0.1"),
+          prolink::kAnnouncePort, INADDR_LOOPBACK + index));
+      ASSERT_TRUE(WaitFor([&]() {
+        for (const auto& device : session.GetDevices()) {
+          if (device.device_number == 0x05 && device.mac_address == mac) {
+            return device.interface_index == index;
+          }
+        }
+        return false;
+      }));
+      session.SendSyncControl(0x05, prolink::SyncCommand::kEnableSync);
+      ASSERT_TRUE(WaitFor([&]() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return control_sources.size() == index + 1u;
+      }));
+    }
+    session.Stop();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    EXPECT_EQ(control_sources[0], htonl(INADDR_LOOPBACK));
+    EXPECT_EQ(control_sources[1], htonl(INADDR_LOOPBACK + 1));
+  }
+}
+#endif
+
+TEST(ReceiveTest, AutoNetworkFillsAddressesAndAnnounces) {
+  prolink::Config config = ListenerConfig();
+  config.auto_network = true;
+  config.network_interface = "127.0.0.0/8";
+  config.send_announces = true;
+  config.announce_interval_ms = 20;
+  prolink::Session session(config);
+  if (!session.Start()) {
+    GTEST_SKIP() << "no loopback address: " << session.GetLastError();
+  }
+  EXPECT_TRUE(WaitFor([&]() { return session.GetMetrics().packets_sent >= 1; }));
+  const auto interfaces = session.GetInterfaces();
+  session.Stop();
+  ASSERT_EQ(interfaces.size(), 1u);
+  EXPECT_EQ(interfaces[0].device_ip, "127.0.0.1");
+  EXPECT_EQ(interfaces[0].broadcast_address, "127.255.255.255");
+  EXPECT_EQ(interfaces[0].announce_address, "127.255.255.255");
+  EXPECT_FALSE(interfaces[0].name.empty());
+  EXPECT_EQ(session.GetMetrics().send_errors, 0u);
+}
+
+TEST(ReceiveTest, AutoNetworkFailsForUnknownInterface) {
+  prolink::Config config = ListenerConfig();
+  config.auto_network = true;
+  config.network_interface = "prolink-none0";
+  prolink::Session session(config);
+  EXPECT_FALSE(session.Start());
+  EXPECT_NE(session.GetLastError().find("prolink-none0"), std::string::npos);
+}
+
+TEST(ReceiveTest, ViewCallbacksSeeEveryPacketWithoutOwningCallbacks) {
+  prolink::Config config = ListenerConfig();
+  prolink::Session session(config);
+
+  std::atomic<int> beat_views{0};
+  std::atomic<int> status_views{0};
+  std::atomic<uint32_t> last_bpm{0};
+  std::atomic<bool> name_ok{false};
+  session.SetBeatViewCallback([&](const prolink::BeatView& view) {
+    last_bpm = view.bpm();
+    name_ok = view.device_name() == "CDJ-2";
+    beat_views.fetch_add(1);
+  });
+  session.SetStatusViewCallback([&](const prolink::StatusView& view) {
+    if (view.is_playing()) {
+      status_views.fetch_add(1);
+    }
+  });
+  ASSERT_TRUE(session.Start()) << session.GetLastError();
+
+  LoopbackSender sender;
+  ASSERT_TRUE(sender.Send(prolink::test::BuildBeatPacket(
+                              0x02, "CDJ-2", 12650, prolink::kNeutralPitch, 1, 500, 2000),
+                          prolink::kBeatPort));
+  ASSERT_TRUE(sender.Send(prolink::test::BuildStatusPacket(
+                              0x02, "CDJ-2", 12650, prolink::kNeutralPitch, 8, 4,
+                              true, false, true, 0xff),
+                          prolink::kStatusPort));
+  EXPECT_TRUE(WaitFor([&]() { return beat_views.load() == 1 && status_views.load() == 1; }));
+  session.Stop();
+  EXPECT_EQ(last_bpm.load(), 12650u);
+  EXPECT_TRUE(name_ok.load());
+  ASSERT_TRUE(session.GetTempoMaster().has_value());
+  EXPECT_EQ(session.GetTempoMaster()->device_name, "CDJ-2");
+}
+
+TEST(ReceiveTest, RawPacketCallbackSeesDatagramsAndCanSkipParsing) {
+  const auto packet = prolink::test::BuildBeatPacket(
+      0x02, "CDJ-2", 12800, prolink::kNeutralPitch, 1, 500, 2000);
+  for (const bool parse : {true, false}) {
+    prolink::Config config = ListenerConfig();
+    config.parse_packets = parse;
+    prolink::Session session(config);
+
+    std::mutex mutex;
+    std::vector<prolink::RawPacket> raws;
+    std::atomic<int> beats{0};
+    session.SetRawPacketCallback([&](const prolink::RawPacket& raw) {
+      std::lock_guard<std::mutex> lock(mutex);
+      raws.push_back(raw);
+    });
+    session.SetBeatCallback([&](const prolink::BeatInfo&) { beats.fetch_add(1); });
+    ASSERT_TRUE(session.Start()) << session.GetLastError();
+
+    LoopbackSender sender;
+    ASSERT_TRUE(sender.Send(packet, prolink::kBeatPort));
+    ASSERT_TRUE(WaitFor([&]() {
+      std::lock_guard<std::mutex> lock(mutex);
+      return !raws.empty();
+    }));
+    if (parse) {
+      EXPECT_TRUE(WaitFor([&]() { return beats.load() == 1; }));
+    }
+    const auto metrics = session.GetMetrics();
+    session.Stop();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    ASSERT_EQ(raws.size(), 1u);
+    EXPECT_EQ(raws[0].size, packet.size());
+    EXPECT_EQ(raws[0].local_port, prolink::kBeatPort);
+    EXPECT_EQ(raws[0].source_ip, htonl(INADDR_LOOPBACK));
+    EXPECT_NE(raws[0].source_port, 0u);
+    EXPECT_FALSE(raws[0].truncated);
+    EXPECT_EQ(metrics.datagrams_received, 1u);
+    EXPECT_EQ(beats.load(), parse ? 1 : 0);
+    EXPECT_EQ(metrics.packets_received, parse ? 1u : 0u);
+  }
+}
+
+TEST(ReceiveTest, PrecisePositionUpdatesLatestSlot) {
+  prolink::Config config = ListenerConfig();
+  prolink::Session session(config);
+
+  std::atomic<int> positions{0};
+  session.SetPositionCallback([&](const prolink::PositionInfo&) { positions.fetch_add(1); });
+  ASSERT_TRUE(session.Start()) << session.GetLastError();
+  EXPECT_FALSE(session.GetLatestPosition(0x03).has_value());
+
+  LoopbackSender sender;
+  ASSERT_TRUE(sender.Send(
+      prolink::test::BuildPositionPacket(0x03, "CDJ-3000", 300, 1000, 0, 1200),
+      prolink::kBeatPort));
+  ASSERT_TRUE(sender.Send(
+      prolink::test::BuildPositionPacket(0x03, "CDJ-3000", 300, 1030, 0, 1200),
+      prolink::kBeatPort));
+  ASSERT_TRUE(WaitFor([&]() { return positions.load() == 2; }));
+
+  const auto latest = session.GetLatestPosition(0x03);
+  session.Stop();
+  ASSERT_TRUE(latest.has_value());
+  EXPECT_EQ(latest->device_number, 0x03);
+  EXPECT_EQ(latest->playhead_ms, 1030u);
+  EXPECT_EQ(latest->bpm, 12000u);
+  EXPECT_NE(latest->receive_time, std::chrono::steady_clock::time_point{});
+  EXPECT_FALSE(session.GetLatestPosition(0x02).has_value());
+  EXPECT_EQ(session.GetMetrics().userspace_rejected, 0u);
+}
+
+TEST(ReceiveTest, MixerPacketsUpdateChannelTable) {
+  prolink::Config config = ListenerConfig();
+  prolink::Session session(config);
+
+  std::atomic<int> on_air_packets{0};
+  std::atomic<int> fader_packets{0};
+  std::atomic<int> mixer_statuses{0};
+  session.SetOnAirCallback([&](const prolink::OnAirInfo&) { on_air_packets.fetch_add(1); });
+  session.SetFaderStartCallback(
+      [&](const prolink::FaderStartInfo&) { fader_packets.fetch_add(1); });
+  session.SetMixerStatusCallback(
+      [&](const prolink::MixerStatusInfo&) { mixer_statuses.fetch_add(1); });
+  ASSERT_TRUE(session.Start()) << session.GetLastError();
+  EXPECT_FALSE(session.IsOnAir(1).has_value());
+  EXPECT_FALSE(session.GetFaderStart(1).has_value());
+
+  using prolink::FaderStartCommand;
+  LoopbackSender sender;
+  ASSERT_TRUE(sender.Send(prolink::test::BuildOnAirPacket(0x21, {true, false, true, false}),
+                          prolink::kBeatPort));
+  ASSERT_TRUE(sender.Send(
+      prolink::test::BuildFaderStartPacket(
+          0x21, {FaderStartCommand::kStart, FaderStartCommand::kNoChange,
+                 FaderStartCommand::kStop, FaderStartCommand::kNoChange}),
+      prolink::kBeatPort));
+  ASSERT_TRUE(sender.Send(
+      prolink::test::BuildMixerStatusPacket(0x21, "DJM-900nexus", 12400, 1, false),
+      prolink::kStatusPort));
+  ASSERT_TRUE(WaitFor([&]() {
+    return on_air_packets.load() == 1 && fader_packets.load() == 1 &&
+           mixer_statuses.load() == 1;
+  }));
+
+  EXPECT_EQ(session.IsOnAir(1), true);
+  EXPECT_EQ(session.IsOnAir(2), false);
+  EXPECT_EQ(session.IsOnAir(3), true);
+  EXPECT_FALSE(session.IsOnAir(5).has_value());
+  EXPECT_EQ(session.GetFaderStart(1), FaderStartCommand::kStart);
+  EXPECT_FALSE(session.GetFaderStart(2).has_value());
+  EXPECT_EQ(session.GetFaderStart(3), FaderStartCommand::kStop);
+  session.Stop();
+  EXPECT_EQ(session.GetMetrics().userspace_rejected, 0u);
+}
+
+TEST(ReceiveTest, ClaimPacketOnAnnouncePortIsNotFaderStart) {
+  prolink::Config config = ListenerConfig();
+  config.kernel_filter = false;
+  prolink::Session session(config);
+
+  std::atomic<int> fader_packets{0};
+  session.SetFaderStartCallback(
+      [&](const prolink::FaderStartInfo&) { fader_packets.fetch_add(1); });
+  ASSERT_TRUE(session.Start()) << session.GetLastError();
+
+  using prolink::FaderStartCommand;
+  auto claim = prolink::test::BuildFaderStartPacket(
+      0x00, {FaderStartCommand::kNoChange, FaderStartCommand::kNoChange,
+             FaderStartCommand::kNoChange, FaderStartCommand::kNoChange});
+  claim.resize(0x32);
+  claim[0x24] = 192;
+  claim[0x25] = 168;
+  LoopbackSender sender;
+  ASSERT_TRUE(sender.Send(claim, prolink::kAnnouncePort));
+  // The same bytes on the beat port carry invalid fader start commands.
+  ASSERT_TRUE(sender.Send(claim, prolink::kBeatPort));
+  ASSERT_TRUE(WaitFor([&]() {
+    const auto metrics = session.GetMetrics();
+    return metrics.userspace_rejected == 2 && metrics.parse_errors == 1;
+  }));
+  session.Stop();
+  EXPECT_EQ(fader_packets.load(), 0);
+  EXPECT_FALSE(session.GetFaderStart(1).has_value());
+  EXPECT_TRUE(session.GetDevices().empty());
+}
+
+TEST(ReceiveTest, SentStatusTracksStateChanges) {
+  prolink::Config config = ListenerConfig();
+  config.broadcast_address = "127.0.0.1";
+  config.send_status = true;
+  prolink::Session session(config);
+
+  std::mutex mutex;
+  std::vector<prolink::StatusInfo> own;
+  session.SetStatusCallback([&](const prolink::StatusInfo& status) {
+    if (status.device_number == config.device_number) {
+      std::lock_guard<std::mutex> lock(mutex);
+      own.push_back(status);
+    }
+  });
+  session.SetTempo(128.0);
+  ASSERT_TRUE(session.Start()) << session.GetLastError();
+  const auto latest = [&]() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return own.empty() ? prolink::StatusInfo{} : own.back();
+  };
+  ASSERT_TRUE(WaitFor([&]() { return latest().bpm == std::optional<uint32_t>(12800); }));
+  EXPECT_FALSE(latest().is_playing);
+
+  // The status packet is patched in place, so every send must reflect the
+  // latest state and keep the identity encoded at construction.
+  session.SetTempo(100.0);
+  session.SetPlaying(true);
+  ASSERT_TRUE(WaitFor([&]() {
+    const auto status = latest();
+    return status.bpm == std::optional<uint32_t>(10000) && status.is_playing;
+  }));
+  const auto status = latest();
+  session.Stop();
+  EXPECT_EQ(status.device_name, config.device_name);
+  EXPECT_EQ(status.play_state, prolink::PlayState::kPlaying);
+  ASSERT_TRUE(status.packet_counter.has_value());
+  EXPECT_GT(status.packet_counter.value(), 1u);
+  EXPECT_EQ(session.GetMetrics().send_errors, 0u);
+}
+
+TEST(ReceiveTest, ControlPacketsUseCachedDestination) {
+  for (const bool connect : {false, true}) {
+    prolink::Config config = ListenerConfig();
+    config.connect_control_sockets = connect;
+    prolink::Session session(config);
+
+    // Source ports of the sync control packets that loop back to us.
+    std::mutex mutex;
+    std::vector<uint16_t> control_ports;
+    session.SetRawPacketCallback([&](const prolink::RawPacket& raw) {
+      if (raw.size > 0x0a && raw.data[0x0a] == 0x2a) {
+        std::lock_guard<std::mutex> lock(mutex);
+        control_ports.push_back(raw.source_port);
+      }
+    });
+    ASSERT_TRUE(session.Start()) << session.GetLastError();
+    prolink::test::InjectKeepAlive(session, 0x05, 0x01, "CDJ-5", "127.0.0.1",
+                                   {0x00, 0x01, 0x02, 0x03, 0x04, 0x05});
+
+    session.SendSyncControl(0x05, prolink::SyncCommand::kEnableSync);
+    session.SendSyncControl(0x05, prolink::SyncCommand::kDisableSync);
+    ASSERT_TRUE(WaitFor([&]() {
+      std::lock_guard<std::mutex> lock(mutex);
+      return control_ports.size() == 2;
+    }));
+    const auto metrics = session.GetMetrics();
+    session.Stop();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    EXPECT_EQ(metrics.broadcast_fallbacks, 0u);
+    EXPECT_EQ(metrics.send_errors, 0u);
+    EXPECT_EQ(metrics.packets_sent, 2u);
+    // Connected sockets send from an ephemeral port, the beat socket from 50001.
+    EXPECT_EQ(control_ports[0] == prolink::kBeatPort, !connect);
+    EXPECT_EQ(control_ports[0], control_ports[1]);
+  }
+}
+
+TEST(ReceiveTest, ConnectedControlSocketsStayBoundedAcrossExpiry) {
+  prolink::Config config = ListenerConfig();
+  config.connect_control_sockets = true;
+  prolink::Session session(config);
+
+  std::mutex mutex;
+  std::vector<uint16_t> control_ports;
+  session.SetRawPacketCallback([&](const prolink::RawPacket& raw) {
+    if (raw.size > 0x0a && raw.data[0x0a] == 0x2a) {
+      std::lock_guard<std::mutex> lock(mutex);
+      control_ports.push_back(raw.source_port);
+    }
+  });
+  ASSERT_TRUE(session.Start()) << session.GetLastError();
+
+  const std::array<uint8_t, 6> mac = {0x00, 0x01, 0x02, 0x03, 0x04, 0x05};
+  auto expire = [&]() {
+    prolink::test::PruneDevices(session,
+                                std::chrono::steady_clock::now() + std::chrono::hours(1));
+    ASSERT_EQ(prolink::test::GetDeviceRecordCount(session), 0u);
+  };
+  size_t fds = 0;
+  for (size_t round = 0; round < 5; ++round) {
+    prolink::test::InjectKeepAlive(session, 0x05, 0x01, "CDJ-5", "127.0.0.1", mac);
+    session.SendSyncControl(0x05, prolink::SyncCommand::kEnableSync);
+    ASSERT_TRUE(WaitFor([&]() {
+      std::lock_guard<std::mutex> lock(mutex);
+      return control_ports.size() == round + 1;
+    }));
+    if (round == 0) {
+      fds = OpenFdCount();
+    }
+    expire();
+  }
+  {
+    // The device's socket survives expiry and is reused when it returns.
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const uint16_t port : control_ports) {
+      EXPECT_EQ(port, control_ports[0]);
+    }
+  }
+  // An address change replaces the socket and closes the old one.
+  for (const char* ip : {"127.0.0.2", "127.0.0.1", "127.0.0.2", "127.0.0.1"}) {
+    prolink::test::InjectKeepAlive(session, 0x05, 0x01, "CDJ-5", ip, mac);
+    session.SendSyncControl(0x05, prolink::SyncCommand::kEnableSync);
+  }
+  EXPECT_EQ(OpenFdCount(), fds);
+  session.Stop();
+  EXPECT_EQ(session.GetMetrics().send_errors, 0u);
+}